@@ -0,0 +1,130 @@
+#ifndef AST_H
+#define AST_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+
+using namespace std;
+
+enum class TipoNodo : uint8_t {
+    PROGRAMA,
+    ALGORITMO,
+    ESCRIBIR,
+    LEER,
+    SI,
+    PARA,
+    MIENTRAS,
+    ASIGNACION,
+    BLOQUE,
+    NUMERO,
+    CADENA,
+    IDENTIFICADOR,
+    OPERACION_BINARIA,
+    EXPRESION,
+    DECLARACION,
+    DIMENSION, // Dimension a[n]: hijo = tamaño
+    ELEMENTO,  // a[i] en una expresión: hijo = índice
+    FUNCION,   // SubProceso/Funcion: hijos = [parámetros, cuerpo, variable de retorno (opcional)]
+    PARAMETRO, // hijo opcional: la palabra "Referencia" de Por Referencia
+    LLAMADA    // nombre(argumentos): hijos = argumentos
+};
+
+// Tipos de las variables, de menor a mayor: la unión de dos tipos es el mayor
+// (un entero que también recibe un real pasa a double, etc.).
+enum class TipoDato : uint8_t {
+    DESCONOCIDO,
+    LOGICO,
+    ENTERO,
+    ENTERO_LARGO,
+    REAL,
+    CADENA
+};
+
+typedef uint32_t NodoId;
+const NodoId NODO_NULO = UINT32_MAX;
+
+// Nodo compacto: los hijos son un rango contiguo dentro de ArbolAST::hijos
+// y el valor apunta al texto de los tokens (no se copia).
+struct NodoAST {
+    TipoNodo tipo;
+    Operador operador; // solo para OPERACION_BINARIA
+    TipoDato tipoDato; // DECLARACION: el declarado; ASIGNACION, LEER, PARA, DIMENSION,
+                       // PARAMETRO y el Hasta de un Para: el inferido (types.h);
+                       // FUNCION y LLAMADA: el que devuelve la función
+    bool arreglo;      // DECLARACION de un arreglo: la declaración la escribe su Dimension;
+                       // PARAMETRO que recibe un arreglo
+    uint32_t primerHijo;
+    uint32_t numHijos;
+    SimboloId simbolo; // nodos con nombre de variable: id de `valor` (symbols.h)
+    string_view valor;
+};
+
+struct RangoHijos {
+    const NodoId* inicio;
+    const NodoId* fin;
+
+    const NodoId* begin() const { return inicio; }
+    const NodoId* end() const { return fin; }
+    size_t size() const { return fin - inicio; }
+    bool empty() const { return inicio == fin; }
+    NodoId operator[](size_t i) const { return inicio[i]; }
+};
+
+// Arena del árbol: todos los nodos de una unidad de compilación viven en un
+// único vector y se liberan juntos al destruir (o limpiar) el árbol.
+// El texto referenciado por los nodos debe vivir al menos lo mismo que el árbol,
+// salvo los valores que crean los pases sobre el árbol, que viven en `textos`.
+// limpiar() conserva toda la memoria para el siguiente árbol.
+class ArbolAST {
+public:
+    vector<NodoAST> nodos;
+    vector<NodoId> hijos;
+    AlmacenTexto textos;
+    NodoId raiz = NODO_NULO;
+
+    const NodoAST& operator[](NodoId id) const { return nodos[id]; }
+
+    RangoHijos hijosDe(NodoId id) const {
+        const NodoAST& nodo = nodos[id];
+        const NodoId* base = hijos.data() + nodo.primerHijo;
+        return {base, base + nodo.numHijos};
+    }
+
+    // Crea un nodo cuyos hijos son pila[marca..]; los saca de la pila.
+    NodoId crearNodo(TipoNodo tipo, string_view valor, vector<NodoId>& pila, size_t marca,
+                     Operador operador = Operador::NINGUNO) {
+        NodoAST nodo{tipo, operador, TipoDato::DESCONOCIDO, false, (uint32_t)hijos.size(), (uint32_t)(pila.size() - marca),
+                     SIN_SIMBOLO, valor};
+        hijos.insert(hijos.end(), pila.begin() + marca, pila.end());
+        pila.resize(marca);
+        nodos.push_back(nodo);
+        return (NodoId)(nodos.size() - 1);
+    }
+
+    NodoId crearHoja(TipoNodo tipo, string_view valor, SimboloId simbolo = SIN_SIMBOLO) {
+        nodos.push_back({tipo, Operador::NINGUNO, TipoDato::DESCONOCIDO, false, (uint32_t)hijos.size(), 0, simbolo, valor});
+        return (NodoId)(nodos.size() - 1);
+    }
+
+    string_view guardarTexto(string_view texto) {
+        return textos.copiar(texto);
+    }
+
+    void reservar(size_t numNodos) {
+        nodos.reserve(numNodos);
+        hijos.reserve(numNodos);
+    }
+
+    void limpiar() {
+        nodos.clear();
+        hijos.clear();
+        textos.limpiar();
+        raiz = NODO_NULO;
+    }
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "compiler.h"
+#include "generator.h"
+#include "generador_pseudo.h"
+#include "lexer.h"
+#include "parser.h"
+#include "serializer.h"
+
+using namespace std;
+
+// Argumentos: líneas del programa y profundidad de anidamiento
+static string programa(const benchmark::State& state) {
+    OpcionesGenerador opciones;
+    opciones.lineas = state.range(0);
+    opciones.profundidad = (int)state.range(1);
+    return generarPseudocodigo(opciones);
+}
+
+static void contarLineas(benchmark::State& state, const string& src) {
+    double lineas = (double)count(src.begin(), src.end(), '\n');
+    state.counters["lineas/s"] = benchmark::Counter(lineas * state.iterations(), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+static void argumentos(benchmark::internal::Benchmark* b) {
+    b->Args({10000, 2})->Args({10000, 8})->Args({200000, 4})->Unit(benchmark::kMillisecond);
+}
+
+static void BM_LexicoSintetico(benchmark::State& state) {
+    string src = programa(state);
+    for (auto _ : state) {
+        vector<Token> tokens = analizarLexico(src);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    contarLineas(state, src);
+}
+BENCHMARK(BM_LexicoSintetico)->Apply(argumentos);
+
+// Mismo análisis sobre un BufferTokens reutilizado entre iteraciones
+static void BM_LexicoBuffer(benchmark::State& state) {
+    string src = programa(state);
+    BufferTokens tokens;
+    for (auto _ : state) {
+        analizarLexico(src, tokens);
+        benchmark::DoNotOptimize(tokens.size());
+    }
+    contarLineas(state, src);
+}
+BENCHMARK(BM_LexicoBuffer)->Apply(argumentos);
+
+// Tercer argumento: hilos del léxico por trozos
+static void BM_LexicoParalelo(benchmark::State& state) {
+    string src = programa(state);
+    BufferTokens tokens;
+    TablaSimbolos simbolos;
+    for (auto _ : state) {
+        simbolos.limpiar();
+        analizarLexicoParalelo(src, tokens, (unsigned)state.range(2), false, &simbolos);
+        benchmark::DoNotOptimize(tokens.size());
+    }
+    contarLineas(state, src);
+}
+BENCHMARK(BM_LexicoParalelo)
+    ->Args({200000, 4, 1})->Args({200000, 4, 2})->Args({200000, 4, 4})->Args({200000, 4, 8})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_Sintaxis(benchmark::State& state) {
+    string src = programa(state);
+    BufferTokens tokens;
+    analizarLexico(src, tokens);
+    ArbolAST arbol;
+    for (auto _ : state) {
+        FlujoTokens flujo(tokens);
+        analizarSintaxis(flujo, arbol);
+        benchmark::DoNotOptimize(arbol.raiz);
+    }
+    state.counters["nodos"] = (double)arbol.nodos.size();
+    contarLineas(state, src);
+}
+BENCHMARK(BM_Sintaxis)->Apply(argumentos);
+
+// Lo que cuesta recuperar el árbol de un .ast frente a BM_Sintaxis
+static void BM_CargarAST(benchmark::State& state) {
+    string src = programa(state);
+    Lexer lexer(src);
+    string serializado = serializarAST(analizarSintaxis(lexer));
+    ArbolAST arbol;
+    for (auto _ : state) {
+        cargarAST(VistaAST(serializado), arbol);
+        benchmark::DoNotOptimize(arbol.raiz);
+    }
+    state.counters["bytes_ast"] = (double)serializado.size();
+    contarLineas(state, src);
+}
+BENCHMARK(BM_CargarAST)->Apply(argumentos);
+
+static void BM_Generacion(benchmark::State& state) {
+    string src = programa(state);
+    vector<Token> tokens = analizarLexico(src);
+    ArbolAST arbol = analizarSintaxis(tokens);
+    for (auto _ : state) {
+        Emisor salida;
+        generarCodigo(arbol, salida);
+        benchmark::DoNotOptimize(salida.bytesEscritos());
+    }
+    contarLineas(state, src);
+}
+BENCHMARK(BM_Generacion)->Apply(argumentos);
+
+// Extremo a extremo en memoria, reutilizando el Compilador como el modo por lotes
+static void BM_CompilacionCompleta(benchmark::State& state) {
+    string src = programa(state);
+    Compilador compilador;
+    Emisor salida;
+    for (auto _ : state) {
+        compilador.compilar(src, salida);
+        benchmark::DoNotOptimize(salida.tomarTexto());
+    }
+    contarLineas(state, src);
+}
+BENCHMARK(BM_CompilacionCompleta)->Apply(argumentos);
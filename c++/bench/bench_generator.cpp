@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "parser.h"
+#include "generator.h"
+
+using namespace std;
+
+// Programa con muchas asignaciones de expresiones largas (árboles profundos).
+static string programaExpresiones(int lineas, int terminos) {
+    string src = "Algoritmo bench\n";
+    for (int l = 0; l < lineas; l++) {
+        src += "    x" + to_string(l % 64) + " <- 1";
+        for (int t = 0; t < terminos; t++) {
+            src += (t % 2) ? " - y" : " + " + to_string(t);
+        }
+        src += "\n";
+    }
+    src += "FinAlgoritmo\n";
+    return src;
+}
+
+// Réplica del despacho anterior: una cadena por nodo comparada contra los literales.
+static const char* NOMBRES_NODO[] = {
+    "PROGRAMA", "ALGORITMO", "ESCRIBIR", "LEER", "SI", "PARA", "MIENTRAS",
+    "ASIGNACION", "BLOQUE", "NUMERO", "CADENA", "IDENTIFICADOR",
+    "OPERACION_BINARIA", "EXPRESION"
+};
+
+static int despachoCadena(const string& tipo) {
+    if (tipo == "PROGRAMA") return 0;
+    else if (tipo == "ALGORITMO") return 1;
+    else if (tipo == "ESCRIBIR") return 2;
+    else if (tipo == "LEER") return 3;
+    else if (tipo == "SI") return 4;
+    else if (tipo == "PARA") return 5;
+    else if (tipo == "MIENTRAS") return 6;
+    else if (tipo == "ASIGNACION") return 7;
+    else if (tipo == "BLOQUE") return 8;
+    else if (tipo == "NUMERO") return 9;
+    else if (tipo == "CADENA") return 10;
+    else if (tipo == "IDENTIFICADOR") return 11;
+    else if (tipo == "OPERACION_BINARIA") return 12;
+    return 13;
+}
+
+static int despachoEnum(TipoNodo tipo) {
+    switch (tipo) {
+    case TipoNodo::PROGRAMA: return 0;
+    case TipoNodo::ALGORITMO: return 1;
+    case TipoNodo::ESCRIBIR: return 2;
+    case TipoNodo::LEER: return 3;
+    case TipoNodo::SI: return 4;
+    case TipoNodo::PARA: return 5;
+    case TipoNodo::MIENTRAS: return 6;
+    case TipoNodo::ASIGNACION: return 7;
+    case TipoNodo::BLOQUE: return 8;
+    case TipoNodo::NUMERO: return 9;
+    case TipoNodo::CADENA: return 10;
+    case TipoNodo::IDENTIFICADOR: return 11;
+    case TipoNodo::OPERACION_BINARIA: return 12;
+    case TipoNodo::EXPRESION: return 13;
+    default: break; // los nodos posteriores no salen en programaExpresiones
+    }
+    return 13;
+}
+
+static void BM_DespachoCadena(benchmark::State& state) {
+    string src = programaExpresiones(state.range(0), 32);
+    vector<Token> tokens = analizarLexico(src);
+    ArbolAST arbol = analizarSintaxis(tokens);
+    vector<string> tipos;
+    for (const NodoAST& nodo : arbol.nodos) tipos.push_back(NOMBRES_NODO[(int)nodo.tipo]);
+
+    for (auto _ : state) {
+        int suma = 0;
+        for (const string& tipo : tipos) suma += despachoCadena(tipo);
+        benchmark::DoNotOptimize(suma);
+    }
+    state.SetItemsProcessed(state.iterations() * tipos.size());
+}
+BENCHMARK(BM_DespachoCadena)->Arg(1000)->Arg(10000);
+
+static void BM_DespachoEnum(benchmark::State& state) {
+    string src = programaExpresiones(state.range(0), 32);
+    vector<Token> tokens = analizarLexico(src);
+    ArbolAST arbol = analizarSintaxis(tokens);
+
+    for (auto _ : state) {
+        int suma = 0;
+        for (const NodoAST& nodo : arbol.nodos) suma += despachoEnum(nodo.tipo);
+        benchmark::DoNotOptimize(suma);
+    }
+    state.SetItemsProcessed(state.iterations() * arbol.nodos.size());
+}
+BENCHMARK(BM_DespachoEnum)->Arg(1000)->Arg(10000);
+
+static void BM_GenerarCodigo(benchmark::State& state) {
+    string src = programaExpresiones(state.range(0), 32);
+    vector<Token> tokens = analizarLexico(src);
+    ArbolAST arbol = analizarSintaxis(tokens);
+
+    for (auto _ : state) {
+        string codigo = generarCodigo(arbol);
+        benchmark::DoNotOptimize(codigo.data());
+    }
+    state.SetItemsProcessed(state.iterations() * arbol.nodos.size());
+}
+BENCHMARK(BM_GenerarCodigo)->Arg(1000)->Arg(10000);
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+#include <cctype>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "scanner.h"
+
+using namespace std;
+
+// Programa grande con sangría, comentarios y cadenas, como los generados por lotes.
+static string programaGrande(size_t bytes) {
+    string src = "Algoritmo bench\n";
+    int l = 0;
+    while (src.size() < bytes) {
+        src += "    // iteracion " + to_string(l) + " del cuerpo principal del programa\n";
+        src += "    Para indice_" + to_string(l % 97) + " <- 1 Hasta 1000000\n";
+        src += "        acumulador_total <- acumulador_total + indice_" + to_string(l % 97) + " * 12345\n";
+        src += "        Escribir \"Procesando el elemento numero de la serie\"\n";
+        src += "    FinPara\n";
+        l++;
+    }
+    src += "FinAlgoritmo\n";
+    return src;
+}
+
+// Versión anterior del lexer (<cctype> byte a byte), como referencia.
+static vector<Token> lexicoReferencia(string_view codigo) {
+    vector<Token> tokens;
+    int linea = 1;
+    size_t i = 0;
+    size_t n = codigo.length();
+
+    while (i < n) {
+        // Saltar espacios en blanco
+        if (isspace(codigo[i])) {
+            if (codigo[i] == '\n') linea++;
+            i++;
+            continue;
+        }
+
+        // Comentarios (//)
+        if (i + 1 < n && codigo[i] == '/' && codigo[i+1] == '/') {
+            while (i < n && codigo[i] != '\n') i++;
+            linea++;
+            continue;
+        }
+
+        // Identificadores y palabras reservadas
+        if (isalpha(codigo[i])) {
+            size_t start = i;
+            while (i < n && (isalnum(codigo[i]) || codigo[i] == '_')) i++;
+
+            string_view valor = codigo.substr(start, i - start);
+            PalabraClave clave = buscarPalabraClave(valor);
+            TipoToken tipo = (clave != PalabraClave::NINGUNA) ? PALABRA_RESERVADA : IDENTIFICADOR;
+
+            tokens.push_back({tipo, valor, linea, clave});
+            continue;
+        }
+
+        // Números
+        if (isdigit(codigo[i])) {
+            size_t start = i;
+            while (i < n && isdigit(codigo[i])) i++;
+            tokens.push_back({NUMERO, codigo.substr(start, i - start), linea});
+            continue;
+        }
+
+        // Cadenas
+        if (codigo[i] == '"') {
+            size_t start = ++i;
+            while (i < n && codigo[i] != '"') {
+                if (codigo[i] == '\n') linea++;
+                i++;
+            }
+            tokens.push_back({CADENA, codigo.substr(start, i - start), linea});
+            if (i < n) i++; // Saltar la comilla de cierre
+            continue;
+        }
+
+        // Operadores y símbolos
+        char c = codigo[i];
+        if (i + 1 < n) {
+            char d = codigo[i+1];
+            if (((c == '<' || c == '>' || c == '=' || c == '!') && d == '=') || (c == '<' && d == '-')) {
+                tokens.push_back({OPERADOR, codigo.substr(i, 2), linea});
+                i += 2;
+                continue;
+            }
+        }
+        
+        // Operadores simples
+        string_view op = codigo.substr(i, 1);
+        if (c == '+' || c == '-' || c == '*' || c == '/' || c == '=' || 
+            c == '<' || c == '>' || c == '(' || c == ')' || c == ',') {
+            tokens.push_back({OPERADOR, op, linea});
+        } else {
+            tokens.push_back({SIMBOLO, op, linea});
+        }
+        i++;
+    }
+
+    return tokens;
+}
+
+static void BM_LexicoReferencia(benchmark::State& state) {
+    string src = programaGrande(state.range(0) << 20);
+    for (auto _ : state) {
+        vector<Token> tokens = lexicoReferencia(src);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_LexicoReferencia)->Arg(1)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_Lexico(benchmark::State& state) {
+    string src = programaGrande(state.range(0) << 20);
+    state.SetLabel(implementacionEscaner());
+    for (auto _ : state) {
+        vector<Token> tokens = analizarLexico(src);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_Lexico)->Arg(1)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_SaltarEspacios(benchmark::State& state) {
+    string src(state.range(0) << 20, ' ');
+    for (size_t i = 0; i < src.size(); i += 61) src[i] = '\n';
+    for (auto _ : state) {
+        int linea = 1;
+        benchmark::DoNotOptimize(saltarEspacios(src.data(), 0, src.size(), linea));
+    }
+    state.SetLabel(implementacionEscaner());
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_SaltarEspacios)->Arg(16)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,142 @@
+#include "generador_pseudo.h"
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const VARIABLES[] = {"x", "y", "suma", "contador", "total", "indice"};
+const char* const OPERADORES[] = {"+", "-", "*", "/", "+", "-", "<", ">", "<=", ">=", "==", "!="};
+const char* const CADENAS[] = {"\"Procesando\"", "\"Resultado parcial\"", "\"Fin del paso\""};
+
+class Generador {
+public:
+    explicit Generador(const OpcionesGenerador& opciones) : opciones(opciones), azar(opciones.semilla) {}
+
+    string generar() {
+        texto = "Algoritmo sintetico\n";
+        // Todas las variables toman valor al principio, fuera de los bloques:
+        // el C++ las declara en su primera aparición y así cualquier lectura
+        // posterior compila
+        for (const char* variable : VARIABLES) {
+            sangria(1);
+            texto += variable;
+            texto += " <- 0\n";
+        }
+        vector<const char*> cierres;
+        for (size_t linea = 0; linea < opciones.lineas; linea++) {
+            int nivel = (int)cierres.size() + 1;
+            unsigned r = numero(100);
+            if (r < 15 && nivel <= opciones.profundidad) {
+                abrirBloque(nivel, cierres);
+            } else if (r < 25 && !cierres.empty()) {
+                sangria(nivel - 1);
+                texto += cierres.back();
+                texto += '\n';
+                cierres.pop_back();
+            } else {
+                sentencia(nivel);
+            }
+        }
+        while (!cierres.empty()) {
+            sangria((int)cierres.size());
+            texto += cierres.back();
+            texto += '\n';
+            cierres.pop_back();
+        }
+        texto += "FinAlgoritmo\n";
+        return move(texto);
+    }
+
+private:
+    unsigned numero(unsigned limite) {
+        return azar() % limite;
+    }
+
+    template <size_t N>
+    const char* elegir(const char* const (&opciones)[N]) {
+        return opciones[numero(N)];
+    }
+
+    void sangria(int nivel) {
+        texto.append(4 * nivel, ' ');
+    }
+
+    void operando() {
+        if (numero(3) == 0) {
+            texto += to_string(numero(1000));
+        } else {
+            texto += elegir(VARIABLES);
+        }
+    }
+
+    void expresion() {
+        operando();
+        int extra = numero(opciones.terminos > 0 ? opciones.terminos : 1);
+        for (int i = 0; i < extra; i++) {
+            texto += ' ';
+            texto += elegir(OPERADORES);
+            texto += ' ';
+            operando();
+        }
+    }
+
+    void abrirBloque(int nivel, vector<const char*>& cierres) {
+        sangria(nivel);
+        switch (numero(3)) {
+        case 0:
+            texto += "Si ";
+            expresion();
+            texto += " Entonces\n";
+            cierres.push_back("FinSi");
+            break;
+        case 1:
+            texto += "Para i <- 1 Hasta ";
+            expresion();
+            texto += '\n';
+            cierres.push_back("FinPara");
+            break;
+        default:
+            texto += "Mientras ";
+            expresion();
+            texto += '\n';
+            cierres.push_back("FinMientras");
+            break;
+        }
+    }
+
+    void sentencia(int nivel) {
+        sangria(nivel);
+        unsigned r = numero(100);
+        if (r < 55) {
+            texto += elegir(VARIABLES);
+            texto += " <- ";
+            expresion();
+        } else if (r < 75) {
+            texto += "Escribir ";
+            if (numero(2) == 0) {
+                texto += elegir(CADENAS);
+            } else {
+                expresion();
+            }
+        } else if (r < 85) {
+            texto += "Leer ";
+            texto += elegir(VARIABLES);
+        } else {
+            texto += "// paso ";
+            texto += to_string(numero(10000));
+        }
+        texto += '\n';
+    }
+
+    OpcionesGenerador opciones;
+    mt19937 azar;
+    string texto;
+};
+
+} // namespace
+
+string generarPseudocodigo(const OpcionesGenerador& opciones) {
+    return Generador(opciones).generar();
+}
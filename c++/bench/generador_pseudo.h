@@ -0,0 +1,24 @@
+#ifndef GENERADOR_PSEUDO_H
+#define GENERADOR_PSEUDO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Parámetros del programa sintético. El mismo conjunto de opciones produce
+// siempre el mismo texto, en cualquier plataforma.
+struct OpcionesGenerador {
+    size_t lineas = 10000;     // líneas del cuerpo del algoritmo (aprox.)
+    int profundidad = 4;       // anidamiento máximo de Si/Para/Mientras
+    int terminos = 3;          // operandos máximos por expresión
+    uint32_t semilla = 1;
+};
+
+// Genera pseudocódigo válido para el parser: asignaciones, Escribir, Leer,
+// comentarios y bloques anidados, con la sangría de los ejemplos del repo.
+// Cada variable se asigna antes de usarse, así el C++ generado compila.
+string generarPseudocodigo(const OpcionesGenerador& opciones);
+
+#endif
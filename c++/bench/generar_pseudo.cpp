@@ -0,0 +1,34 @@
+// Escribe un programa sintético en stdout para pruebas de carga:
+//   generar_pseudo [--lineas N] [--profundidad D] [--terminos T] [--semilla S] > grande.pseudo
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "generador_pseudo.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    OpcionesGenerador opciones;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Uso: " << argv[0] << " [--lineas N] [--profundidad D] [--terminos T] [--semilla S]" << endl;
+            return 1;
+        }
+        long valor = atol(argv[++i]);
+        if (arg == "--lineas") {
+            opciones.lineas = (size_t)valor;
+        } else if (arg == "--profundidad") {
+            opciones.profundidad = (int)valor;
+        } else if (arg == "--terminos") {
+            opciones.terminos = (int)valor;
+        } else if (arg == "--semilla") {
+            opciones.semilla = (uint32_t)valor;
+        } else {
+            cerr << "Opción desconocida: " << arg << endl;
+            return 1;
+        }
+    }
+    cout << generarPseudocodigo(opciones);
+    return cout.fail() ? 1 : 0;
+}
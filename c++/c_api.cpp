@@ -0,0 +1,60 @@
+#include "c_api.h"
+#include <exception>
+#include <new>
+#include <string>
+#include <string_view>
+#include "compiler.h"
+
+using namespace std;
+
+struct CompiladorC {
+    explicit CompiladorC(const OpcionesCompilacion& opciones) : compilador(opciones) {}
+
+    Compilador compilador;
+    string error; // el mensaje de la última llamada que falló
+};
+
+namespace {
+
+OpcionesCompilacion opcionesDe(unsigned opciones) {
+    OpcionesCompilacion resultado;
+    resultado.ignorarMayusculas = opciones & COMPILADOR_IGNORAR_MAYUSCULAS;
+    resultado.optimizar = opciones & COMPILADOR_OPTIMIZAR;
+    resultado.codigo.paralelizar = opciones & COMPILADOR_PARALELIZAR;
+    resultado.codigo.vectorizar = opciones & COMPILADOR_VECTORIZAR;
+    if (opciones & COMPILADOR_FAST_IO) resultado.codigo.entradaSalida = ModoES::RAPIDA;
+    if (opciones & COMPILADOR_FAST_IO_BUFFER) resultado.codigo.entradaSalida = ModoES::BUFFER;
+    resultado.emitirAST = opciones & COMPILADOR_EMITIR_AST;
+    return resultado;
+}
+
+} // namespace
+
+CompiladorC* compilador_crear(unsigned opciones) {
+    return new (nothrow) CompiladorC(opcionesDe(opciones));
+}
+
+void compilador_destruir(CompiladorC* compilador) {
+    delete compilador;
+}
+
+int compilador_compilar(CompiladorC* compilador, const char* fuente, size_t longitud,
+                        const char** salida, size_t* longitudSalida) {
+    // Ninguna excepción puede cruzar la frontera de C
+    string_view resultado;
+    int estado = 0;
+    try {
+        resultado = compilador->compilador.compilarEnBuffer(string_view(fuente, longitud));
+    } catch (const exception& e) {
+        compilador->error = e.what();
+        resultado = compilador->error;
+        estado = 1;
+    } catch (...) {
+        compilador->error = "Error desconocido";
+        resultado = compilador->error;
+        estado = 1;
+    }
+    *salida = resultado.data();
+    *longitudSalida = resultado.size();
+    return estado;
+}
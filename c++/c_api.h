@@ -0,0 +1,41 @@
+#ifndef C_API_H
+#define C_API_H
+
+#include <stddef.h>
+
+/* Interfaz C del compilador (libpseudocompilador.so) para usarlo dentro de
+ * otro proceso, p. ej. desde Python con ctypes (compilador_nativo.py), sin
+ * lanzar proyecto_compiladores ni pasar por archivos. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Opciones de compilador_crear (se combinan con |) */
+#define COMPILADOR_IGNORAR_MAYUSCULAS 1u
+#define COMPILADOR_OPTIMIZAR          2u
+#define COMPILADOR_PARALELIZAR        4u
+#define COMPILADOR_VECTORIZAR         8u
+#define COMPILADOR_FAST_IO           16u
+#define COMPILADOR_FAST_IO_BUFFER    32u
+#define COMPILADOR_EMITIR_AST        64u /* la salida es el árbol serializado (serializer.h) */
+
+typedef struct CompiladorC CompiladorC;
+
+/* NULL si no hay memoria. Cada compilador conserva su árbol y sus tablas
+ * entre llamadas; no se debe usar desde dos hilos a la vez. */
+CompiladorC* compilador_crear(unsigned opciones);
+void compilador_destruir(CompiladorC* compilador);
+
+/* Compila `longitud` bytes de `fuente` (pseudocódigo o árbol serializado,
+ * alineado a 4 bytes). Devuelve 0 y el C++ en *salida, o 1 y el mensaje de
+ * error. *salida apunta a memoria del compilador (sin terminar en '\0'),
+ * válida hasta la siguiente llamada o hasta destruirlo. */
+int compilador_compilar(CompiladorC* compilador, const char* fuente, size_t longitud,
+                        const char** salida, size_t* longitudSalida);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
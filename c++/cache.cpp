@@ -0,0 +1,169 @@
+#include "cache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Dos funciones de mezcla independientes (FNV-1a y una multiplicativa con
+// rotación) para obtener 128 bits sin depender de una biblioteca externa.
+struct Mezclador {
+    uint64_t a;
+    uint64_t b;
+
+    void byte(unsigned char c) {
+        a = (a ^ c) * 0x100000001B3ull;
+        b = ((b ^ c) * 0x9E3779B97F4A7C15ull);
+        b ^= b >> 29;
+    }
+
+    void bytes(string_view texto) {
+        for (char c : texto) byte((unsigned char)c);
+    }
+
+    void numero(uint32_t n) {
+        for (int i = 0; i < 4; i++) byte((unsigned char)(n >> (8 * i)));
+    }
+};
+
+unsigned long long idProceso() {
+#ifdef _WIN32
+    return (unsigned long long)_getpid();
+#else
+    return (unsigned long long)getpid();
+#endif
+}
+
+} // namespace
+
+string HuellaTokens::hex() const {
+    char texto[33];
+    snprintf(texto, sizeof(texto), "%016llx%016llx", (unsigned long long)a, (unsigned long long)b);
+    return texto;
+}
+
+HuellaTokens calcularHuella(const BufferTokens& tokens, uint64_t semilla, bool textoPalabras) {
+    Mezclador mezcla{0xCBF29CE484222325ull ^ semilla, 0x2545F4914F6CDD1Dull + semilla};
+    size_t cursor = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        TipoToken tipo = tokens.tipo(i);
+        // El parser mira los saltos de línea ("fin si" solo cierra en una línea)
+        mezcla.byte((unsigned char)tipo | (tokens.empiezaLinea(i, cursor) ? 0x80 : 0));
+        if (tipo == PALABRA_RESERVADA && !textoPalabras) {
+            mezcla.byte(tokens.detalle(i));
+        } else {
+            // La longitud evita que "ab" "c" y "a" "bc" coincidan
+            string_view valor = tokens.valor(i);
+            mezcla.numero((uint32_t)valor.size());
+            mezcla.bytes(valor);
+        }
+    }
+    return {mezcla.a, mezcla.b};
+}
+
+CacheCompilacion::CacheCompilacion(const string& directorio, size_t maxBytesMemoria)
+    : directorio(directorio), maxBytes(maxBytesMemoria), bytes(0), numAciertos(0), numFallos(0) {
+    if (!directorio.empty()) {
+        error_code ec;
+        filesystem::create_directories(directorio, ec);
+    }
+}
+
+string CacheCompilacion::rutaEnDisco(const HuellaTokens& huella) const {
+    return (filesystem::path(directorio) / (huella.hex() + ".cpp")).string();
+}
+
+shared_ptr<const string> CacheCompilacion::buscar(const HuellaTokens& huella) {
+    {
+        lock_guard<mutex> lock(m);
+        auto it = entradas.find(huella);
+        if (it != entradas.end()) {
+            recientes.splice(recientes.begin(), recientes, it->second.posicion);
+            numAciertos++;
+            return it->second.codigo;
+        }
+    }
+
+    if (!directorio.empty()) {
+        ifstream archivo(rutaEnDisco(huella), ios::binary | ios::ate);
+        if (archivo.is_open()) {
+            string codigo(static_cast<size_t>(archivo.tellg()), '\0');
+            archivo.seekg(0);
+            if (archivo.read(&codigo[0], codigo.size())) {
+                auto compartido = make_shared<const string>(move(codigo));
+                lock_guard<mutex> lock(m);
+                guardarEnMemoria(huella, compartido);
+                numAciertos++;
+                return compartido;
+            }
+        }
+    }
+
+    lock_guard<mutex> lock(m);
+    numFallos++;
+    return nullptr;
+}
+
+void CacheCompilacion::guardar(const HuellaTokens& huella, string codigo) {
+    auto compartido = make_shared<const string>(move(codigo));
+
+    if (!directorio.empty()) {
+        // Escribir aparte y renombrar: otro proceso nunca ve un archivo a medias.
+        // El temporal es de este proceso y este hilo (el id de hilo solo no
+        // distingue procesos que comparten el directorio), y si la escritura
+        // falla (disco lleno...) no se publica.
+        string ruta = rutaEnDisco(huella);
+        string temporal = ruta + ".tmp" + to_string(idProceso()) + "-" +
+                          to_string(hash<thread::id>()(this_thread::get_id()));
+        ofstream archivo(temporal, ios::binary);
+        archivo.write(compartido->data(), compartido->size());
+        archivo.close();
+        error_code ec;
+        if (archivo) filesystem::rename(temporal, ruta, ec);
+        if (!archivo || ec) filesystem::remove(temporal, ec);
+    }
+
+    lock_guard<mutex> lock(m);
+    guardarEnMemoria(huella, compartido);
+}
+
+void CacheCompilacion::guardarEnMemoria(const HuellaTokens& huella, shared_ptr<const string> codigo) {
+    if (codigo->size() > maxBytes) return;
+
+    auto it = entradas.find(huella);
+    if (it != entradas.end()) {
+        bytes -= it->second.codigo->size();
+        recientes.erase(it->second.posicion);
+        entradas.erase(it);
+    }
+
+    while (bytes + codigo->size() > maxBytes && !recientes.empty()) {
+        auto viejo = entradas.find(recientes.back());
+        bytes -= viejo->second.codigo->size();
+        entradas.erase(viejo);
+        recientes.pop_back();
+    }
+
+    recientes.push_front(huella);
+    bytes += codigo->size();
+    entradas[huella] = Entrada{move(codigo), recientes.begin()};
+}
+
+size_t CacheCompilacion::aciertos() const {
+    lock_guard<mutex> lock(m);
+    return numAciertos;
+}
+
+size_t CacheCompilacion::fallos() const {
+    lock_guard<mutex> lock(m);
+    return numFallos;
+}
@@ -0,0 +1,67 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "lexer.h"
+
+using namespace std;
+
+// Huella de 128 bits de un flujo de tokens. Solo depende del tipo, la palabra
+// reservada y el texto de cada token y de qué tokens empiezan línea: espacios,
+// comentarios, números de línea y cómo se escribió una palabra reservada (salvo
+// con textoPalabras) no cambian la huella.
+struct HuellaTokens {
+    uint64_t a;
+    uint64_t b;
+
+    bool operator==(const HuellaTokens& otra) const { return a == otra.a && b == otra.b; }
+    string hex() const;
+};
+
+// `semilla` distingue opciones de compilación que cambian la salida. Con
+// `textoPalabras` también cuenta cómo se escribió cada palabra reservada: hace
+// falta si la salida conserva el texto del programa (el árbol de --ast).
+HuellaTokens calcularHuella(const BufferTokens& tokens, uint64_t semilla, bool textoPalabras = false);
+
+// Caché de C++ generado, en memoria (LRU acotada en bytes) y opcionalmente en
+// disco (un archivo <huella>.cpp por entrada). Segura entre hilos.
+class CacheCompilacion {
+public:
+    explicit CacheCompilacion(const string& directorio = "", size_t maxBytesMemoria = 64u << 20);
+
+    // nullptr si no está ni en memoria ni en disco
+    shared_ptr<const string> buscar(const HuellaTokens& huella);
+    void guardar(const HuellaTokens& huella, string codigo);
+
+    size_t aciertos() const;
+    size_t fallos() const;
+
+private:
+    struct HashHuella {
+        size_t operator()(const HuellaTokens& h) const { return (size_t)(h.a ^ (h.b * 0x9E3779B97F4A7C15ull)); }
+    };
+    struct Entrada {
+        shared_ptr<const string> codigo;
+        list<HuellaTokens>::iterator posicion;
+    };
+
+    void guardarEnMemoria(const HuellaTokens& huella, shared_ptr<const string> codigo);
+    string rutaEnDisco(const HuellaTokens& huella) const;
+
+    string directorio;
+    size_t maxBytes;
+    size_t bytes;
+    size_t numAciertos;
+    size_t numFallos;
+    list<HuellaTokens> recientes; // el más reciente al principio
+    unordered_map<HuellaTokens, Entrada, HashHuella> entradas;
+    mutable mutex m;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Compilador de pseudocódigo dentro del propio proceso de Python.
+
+Carga ``libpseudocompilador.so`` (interfaz C de c_api.h) con ctypes: no lanza
+``proyecto_compiladores`` ni escribe input.pseudo para luego leer el .cpp.
+La entrada puede ser ``str`` o cualquier objeto con protocolo de buffer
+(``bytes``, ``bytearray``, ``memoryview``, un ``mmap``...). ``bytes`` y los
+buffers escribibles se pasan al compilador sin copiarlos; ctypes no da la
+dirección de un buffer de solo lectura, así que esos se copian una vez.
+"""
+import ctypes
+import os
+
+IGNORAR_MAYUSCULAS = 1
+OPTIMIZAR = 2
+PARALELIZAR = 4
+VECTORIZAR = 8
+FAST_IO = 16
+FAST_IO_BUFFER = 32
+EMITIR_AST = 64
+
+NOMBRE_BIBLIOTECA = "libpseudocompilador.so"
+
+
+class ErrorCompilacion(Exception):
+    """El compilador devolvió un error."""
+
+
+def _cargar(ruta):
+    biblioteca = ctypes.CDLL(ruta)
+    biblioteca.compilador_crear.argtypes = [ctypes.c_uint]
+    biblioteca.compilador_crear.restype = ctypes.c_void_p
+    biblioteca.compilador_destruir.argtypes = [ctypes.c_void_p]
+    biblioteca.compilador_destruir.restype = None
+    biblioteca.compilador_compilar.argtypes = [
+        ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t,
+        ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_size_t)]
+    biblioteca.compilador_compilar.restype = ctypes.c_int
+    return biblioteca
+
+
+def ruta_biblioteca(compiler_path="./build/proyecto_compiladores"):
+    """La biblioteca se construye junto al ejecutable del compilador."""
+    return os.path.join(os.path.dirname(compiler_path) or ".", NOMBRE_BIBLIOTECA)
+
+
+def disponible(compiler_path="./build/proyecto_compiladores"):
+    return os.path.exists(ruta_biblioteca(compiler_path))
+
+
+def _puntero(entrada):
+    """Puntero y longitud de la entrada; el tercer valor la mantiene viva."""
+    if isinstance(entrada, str):
+        entrada = entrada.encode("utf-8")
+    if isinstance(entrada, bytes):
+        # c_char_p apunta al buffer del propio bytes
+        return ctypes.cast(ctypes.c_char_p(entrada), ctypes.c_void_p), len(entrada), entrada
+    vista = memoryview(entrada).cast("B")
+    if vista.readonly:
+        copia = vista.tobytes()
+        return ctypes.cast(ctypes.c_char_p(copia), ctypes.c_void_p), len(copia), copia
+    buffer = (ctypes.c_char * len(vista)).from_buffer(vista)
+    return ctypes.cast(buffer, ctypes.c_void_p), len(vista), buffer
+
+
+class CompiladorNativo:
+    """Un compilador residente en este proceso (no compartir entre hilos)."""
+
+    def __init__(self, opciones=IGNORAR_MAYUSCULAS, compiler_path="./build/proyecto_compiladores",
+                 ruta=None):
+        self.biblioteca = _cargar(ruta or ruta_biblioteca(compiler_path))
+        self.compilador = self.biblioteca.compilador_crear(opciones)
+        if not self.compilador:
+            raise MemoryError("No se pudo crear el compilador")
+
+    def compilar_buffer(self, entrada):
+        """Devuelve un memoryview sobre la salida, válido hasta la siguiente llamada."""
+        puntero, longitud, vivo = _puntero(entrada)
+        salida = ctypes.c_void_p()
+        longitud_salida = ctypes.c_size_t()
+        estado = self.biblioteca.compilador_compilar(self.compilador, puntero, longitud,
+                                                     ctypes.byref(salida), ctypes.byref(longitud_salida))
+        del vivo
+        datos = memoryview((ctypes.c_char * longitud_salida.value).from_address(salida.value or 0)).cast("B")
+        if estado != 0:
+            raise ErrorCompilacion(bytes(datos).decode("utf-8", errors="replace"))
+        return datos
+
+    def compilar(self, entrada):
+        """Devuelve el C++ generado; lanza ErrorCompilacion si falla."""
+        return bytes(self.compilar_buffer(entrada)).decode("utf-8", errors="replace")
+
+    def cerrar(self):
+        if getattr(self, "compilador", None):
+            self.biblioteca.compilador_destruir(self.compilador)
+            self.compilador = None
+
+    def __del__(self):
+        self.cerrar()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.cerrar()
@@ -0,0 +1,344 @@
+#include "compiler.h"
+#include "lexer.h"
+#include "parser.h"
+#include "serializer.h"
+#include "generator.h"
+#include "optimizer.h"
+#include "types.h"
+#include "utils.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+// Subir al cambiar el código que genera generarCodigo
+const uint64_t VERSION_GENERADOR = 9;
+
+const string SUFIJO_TEMPORAL = ".tmp";
+
+} // namespace
+
+uint64_t semillaCache(const OpcionesCompilacion& opciones) {
+    uint64_t semilla = VERSION_GENERADOR << 32;
+    if (opciones.ignorarMayusculas) semilla |= 1;
+    if (opciones.optimizar) semilla |= 2;
+    semilla |= (uint64_t)opciones.codigo.entradaSalida << 2;
+    if (opciones.codigo.paralelizar) semilla |= 16;
+    if (opciones.codigo.vectorizar) semilla |= 32;
+    if (opciones.emitirAST) semilla |= 64;
+    return semilla;
+}
+
+string archivoSalida(const string& entrada, const OpcionesCompilacion& opciones) {
+    return cambiarExtension(entrada, opciones.emitirAST ? ".ast" : ".cpp");
+}
+
+Compilador::Compilador(const OpcionesCompilacion& opciones) : opciones(opciones) {}
+
+void Compilador::compilar(string_view fuente, Emisor& salida) {
+    if (esASTSerializado(fuente)) {
+        compilarArbolSerializado(fuente, salida);
+        return;
+    }
+    simbolos.limpiar();
+    bool lexicoParalelo = opciones.hilosLexico > 1 && fuente.size() >= 2 * MIN_TROZO_LEXICO;
+    if (!opciones.cache && !opciones.estadisticas && !lexicoParalelo) {
+        Lexer lexer(fuente, opciones.ignorarMayusculas, &simbolos);
+        FlujoTokens flujo(lexer);
+        analizarSintaxis(flujo, arbol, memoriaParser);
+        if (opciones.optimizar) optimizarArbol(arbol);
+        inferirTipos(arbol, memoriaTipos);
+        generar(salida);
+        // El árbol apunta a `fuente`: no dejar vistas colgando para la siguiente
+        arbol.limpiar();
+        return;
+    }
+    compilarPorFases(fuente, salida);
+}
+
+// Con caché o estadísticas el léxico se hace entero antes del análisis: la
+// huella necesita el flujo completo y así cada fase se mide por separado. Un
+// archivo grande con hilosLexico también pasa por aquí, para analizarlo en trozos.
+void Compilador::compilarPorFases(string_view fuente, Emisor& salida) {
+    bool medir = opciones.estadisticas;
+    uint64_t marca = 0;
+    ContadorMemoria memoriaInicial{0, 0};
+    uint64_t escritosInicial = salida.bytesEscritos();
+    if (medir) {
+        medidas = EstadisticasCompilacion();
+        medidas.archivos = 1;
+        medidas.bytesEntrada = fuente.size();
+        memoriaInicial = memoriaDelHilo();
+        marca = relojNs();
+    }
+    // Cierra la fase en curso sumando su duración a `fase`
+    auto cerrarFase = [&](uint64_t& fase) {
+        uint64_t ahora = relojNs();
+        fase += ahora - marca;
+        marca = ahora;
+    };
+    auto terminar = [&]() {
+        if (!medir) return;
+        ContadorMemoria memoriaFinal = memoriaDelHilo();
+        medidas.reservas = memoriaFinal.reservas - memoriaInicial.reservas;
+        medidas.bytesReservados = memoriaFinal.bytes - memoriaInicial.bytes;
+        medidas.sinReservas = medidas.reservas == 0;
+        medidas.bytesSalida = salida.bytesEscritos() - escritosInicial;
+    };
+
+    analizarLexicoParalelo(fuente, tokens, opciones.hilosLexico, opciones.ignorarMayusculas, &simbolos);
+    if (medir) {
+        cerrarFase(medidas.nsLexico);
+        medidas.tokens = tokens.size();
+    }
+
+    HuellaTokens huella{};
+    if (opciones.cache) {
+        huella = calcularHuella(tokens, semillaCache(opciones), opciones.emitirAST);
+        if (shared_ptr<const string> guardado = opciones.cache->buscar(huella)) {
+            salida << *guardado;
+            if (medir) cerrarFase(medidas.nsGeneracion);
+            terminar();
+            return;
+        }
+    }
+
+    // En caché se genera en memoria para poder guardar el texto
+    Emisor enMemoria;
+    Emisor& destino = opciones.cache ? enMemoria : salida;
+    try {
+        FlujoTokens flujo(tokens, &simbolos);
+        analizarSintaxis(flujo, arbol, memoriaParser);
+        if (opciones.optimizar) optimizarArbol(arbol);
+        inferirTipos(arbol, memoriaTipos);
+        if (medir) {
+            cerrarFase(medidas.nsSintaxis);
+            medidas.nodos = arbol.nodos.size();
+        }
+        generar(destino);
+    } catch (...) {
+        arbol.limpiar();
+        throw;
+    }
+    arbol.limpiar();
+
+    if (opciones.cache) {
+        string codigo = enMemoria.tomarTexto();
+        salida << codigo;
+        opciones.cache->guardar(huella, move(codigo));
+    }
+    if (medir) cerrarFase(medidas.nsGeneracion);
+    terminar();
+}
+
+// El árbol ya viene optimizado y con tipos: sus valores apuntan a `datos`, sin
+// copiarlos, y no pasa por la caché (no hay tokens de los que sacar la huella)
+void Compilador::compilarArbolSerializado(string_view datos, Emisor& salida) {
+    uint64_t marca = 0;
+    uint64_t escritosInicial = salida.bytesEscritos();
+    if (opciones.estadisticas) {
+        medidas = EstadisticasCompilacion();
+        medidas.archivos = 1;
+        medidas.bytesEntrada = datos.size();
+        marca = relojNs();
+    }
+    cargarAST(VistaAST(datos), arbol);
+    try {
+        generar(salida);
+    } catch (...) {
+        arbol.limpiar();
+        throw;
+    }
+    if (opciones.estadisticas) {
+        medidas.nodos = arbol.nodos.size();
+        medidas.nsGeneracion = relojNs() - marca;
+        medidas.bytesSalida = salida.bytesEscritos() - escritosInicial;
+    }
+    arbol.limpiar();
+}
+
+void Compilador::generar(Emisor& salida) {
+    if (opciones.emitirAST) {
+        serializarAST(arbol, salida);
+    } else {
+        generarCodigo(arbol, salida, opciones.codigo, memoriaGenerador);
+    }
+}
+
+void Compilador::ejecutar(string_view fuente, istream& entrada, ostream& salida,
+                          const OpcionesEjecucion& ejecucion) {
+    if (esASTSerializado(fuente)) {
+        cargarAST(VistaAST(fuente), arbol);
+    } else {
+        simbolos.limpiar();
+        Lexer lexer(fuente, opciones.ignorarMayusculas, &simbolos);
+        FlujoTokens flujo(lexer);
+        analizarSintaxis(flujo, arbol, memoriaParser);
+        if (opciones.optimizar) optimizarArbol(arbol);
+        inferirTipos(arbol, memoriaTipos);
+    }
+    try {
+        ejecutarArbol(arbol, entrada, salida, ejecucion);
+    } catch (...) {
+        arbol.limpiar();
+        throw;
+    }
+    arbol.limpiar();
+}
+
+string Compilador::compilar(string_view fuente) {
+    Emisor salida;
+    compilar(fuente, salida);
+    return salida.tomarTexto();
+}
+
+string_view Compilador::compilarEnBuffer(string_view fuente) {
+    salidaMemoria.limpiar();
+    try {
+        compilar(fuente, salidaMemoria);
+    } catch (...) {
+        salidaMemoria.limpiar();
+        throw;
+    }
+    return salidaMemoria.texto();
+}
+
+ResultadoCompilacion Compilador::compilarArchivo(const string& filename) {
+    ResultadoCompilacion resultado;
+    resultado.entrada = filename;
+
+    ArchivoMapeado archivo(filename);
+    string_view fuente = archivo.contenido();
+    resultado.bytesEntrada = fuente.size();
+    if (fuente.empty()) {
+        resultado.error = "No se pudo leer el archivo o está vacío.";
+        return resultado;
+    }
+    // El .ast de salida podría ser el mismo archivo que se está leyendo
+    if (opciones.emitirAST && esASTSerializado(fuente)) {
+        resultado.error = "El archivo ya es un árbol serializado.";
+        return resultado;
+    }
+
+    // Se escribe en un temporal que solo se renombra si todo va bien: un error
+    // no deja un .cpp vacío o a medias y el de la compilación anterior se queda
+    string temporal;
+    FILE* destino = abrirArchivoSalida(archivoSalida(filename, opciones) + SUFIJO_TEMPORAL, temporal);
+    if (!destino) {
+        resultado.error = "No se pudo crear el archivo de salida.";
+        return resultado;
+    }
+    resultado.salida = temporal.substr(0, temporal.size() - SUFIJO_TEMPORAL.size());
+
+    salidaArchivo.cambiarDestino(destino);
+    uint64_t inicioGuardado = 0;
+    try {
+        compilar(fuente, salidaArchivo);
+        if (opciones.estadisticas) inicioGuardado = relojNs();
+        salidaArchivo.vaciar();
+        resultado.exito = !salidaArchivo.fallo();
+        if (!resultado.exito) resultado.error = "Error al escribir " + resultado.salida;
+    } catch (const exception& e) {
+        arbol.limpiar();
+        resultado.error = e.what();
+    }
+    salidaArchivo.cambiarDestino(nullptr);
+
+    if (fclose(destino) != 0 && resultado.exito) {
+        resultado.exito = false;
+        resultado.error = "Error al escribir " + resultado.salida;
+    }
+    error_code ec;
+    if (resultado.exito) {
+        filesystem::rename(temporal, resultado.salida, ec);
+        if (ec) {
+            resultado.exito = false;
+            resultado.error = "Error al escribir " + resultado.salida;
+        }
+    }
+    if (!resultado.exito) filesystem::remove(temporal, ec);
+    if (opciones.estadisticas) {
+        resultado.estadisticas = medidas;
+        // El guardado es lo que queda por volcar al terminar la generación
+        if (inicioGuardado) resultado.estadisticas.nsGuardado = relojNs() - inicioGuardado;
+    }
+    return resultado;
+}
+
+string compilarPseudocodigo(string_view fuente, const OpcionesCompilacion& opciones) {
+    Compilador compilador(opciones);
+    return compilador.compilar(fuente);
+}
+
+vector<ResultadoCompilacion> compilarLote(const vector<string>& entradas,
+                                          const OpcionesCompilacion& opciones, unsigned hilos) {
+    // Agrupar por archivo de salida (abrirArchivoSalida usa el nombre base)
+    vector<vector<size_t>> grupos;
+    unordered_map<string, size_t> grupoDeSalida;
+    for (size_t i = 0; i < entradas.size(); i++) {
+        string salida = filesystem::path(archivoSalida(entradas[i], opciones)).filename().string();
+        auto it = grupoDeSalida.emplace(salida, grupos.size()).first;
+        if (it->second == grupos.size()) grupos.emplace_back();
+        grupos[it->second].push_back(i);
+    }
+
+    hilos = (unsigned)max<size_t>(1, min<size_t>(hilos, grupos.size()));
+    vector<unique_ptr<Compilador>> compiladores;
+    for (unsigned h = 0; h < hilos; h++) {
+        compiladores.push_back(make_unique<Compilador>(opciones));
+    }
+
+    vector<ResultadoCompilacion> resultados(entradas.size());
+    ejecutarConRobo(grupos.size(), hilos, [&](unsigned trabajador, size_t grupo) {
+        for (size_t i : grupos[grupo]) {
+            resultados[i] = compiladores[trabajador]->compilarArchivo(entradas[i]);
+        }
+    });
+    return resultados;
+}
+
+vector<string> expandirEntradas(const vector<string>& rutas, const vector<string>& manifiestos) {
+    vector<string> entradas;
+
+    for (const string& ruta : rutas) {
+        error_code ec;
+        if (!filesystem::is_directory(ruta, ec)) {
+            entradas.push_back(ruta);
+            continue;
+        }
+        vector<string> delDirectorio;
+        for (const auto& item : filesystem::directory_iterator(ruta, ec)) {
+            if (item.is_regular_file(ec) && item.path().extension() == ".pseudo") {
+                delDirectorio.push_back(item.path().string());
+            }
+        }
+        sort(delDirectorio.begin(), delDirectorio.end());
+        entradas.insert(entradas.end(), delDirectorio.begin(), delDirectorio.end());
+    }
+
+    for (const string& manifiesto : manifiestos) {
+        ifstream lista(manifiesto);
+        if (!lista.is_open()) {
+            throw runtime_error("No se pudo leer el manifiesto " + manifiesto);
+        }
+        // Las rutas relativas se toman respecto al directorio del manifiesto
+        filesystem::path base = filesystem::path(manifiesto).parent_path();
+        string linea;
+        while (getline(lista, linea)) {
+            size_t inicio = linea.find_first_not_of(" \t\r");
+            if (inicio == string::npos || linea[inicio] == '#') continue;
+            size_t fin = linea.find_last_not_of(" \t\r");
+            filesystem::path ruta = linea.substr(inicio, fin - inicio + 1);
+            entradas.push_back((ruta.is_relative() ? base / ruta : ruta).string());
+        }
+    }
+
+    return entradas;
+}
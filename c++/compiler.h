@@ -0,0 +1,116 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.h"
+#include "cache.h"
+#include "emitter.h"
+#include "generator.h"
+#include "interpreter.h"
+#include "lexer.h"
+#include "parser.h"
+#include "stats.h"
+#include "types.h"
+
+using namespace std;
+
+struct OpcionesCompilacion {
+    bool ignorarMayusculas = false;
+    // Plegado de constantes y eliminación de ramas muertas (optimizer.h)
+    bool optimizar = false;
+    OpcionesCodigo codigo;
+    // Compartida entre compiladores (y por tanto entre hilos); nullptr = sin caché
+    CacheCompilacion* cache = nullptr;
+    // Modo servidor: cada conexión trata sus peticiones como versiones sucesivas
+    // del mismo programa y solo recompila las sentencias que cambian
+    bool incremental = false;
+    // Medir cada fase (--stats). Desactivado, el lexer alimenta al parser sin
+    // pasar por un buffer de tokens y no se toma ningún tiempo.
+    bool estadisticas = false;
+    // Hilos para el léxico de un archivo grande (analizarLexicoParalelo). En
+    // los lotes ya se reparten los archivos entre hilos y se deja en 1.
+    unsigned hilosLexico = 1;
+    // --ast: en vez del C++ se escribe el árbol analizado (serializer.h) y los
+    // archivos salen con extensión .ast
+    bool emitirAST = false;
+};
+
+// Semilla de la huella de caché para estas opciones. Incluye una versión del
+// generador: cambiarla invalida las entradas guardadas en disco.
+uint64_t semillaCache(const OpcionesCompilacion& opciones);
+// Archivo que escribe compilarArchivo para `entrada`: .cpp, o .ast con emitirAST
+string archivoSalida(const string& entrada, const OpcionesCompilacion& opciones);
+
+struct ResultadoCompilacion {
+    string entrada;
+    string salida;   // ruta donde se escribió el .cpp (o el .ast)
+    bool exito = false;
+    string error;
+    size_t bytesEntrada = 0;
+    EstadisticasCompilacion estadisticas; // solo con OpcionesCompilacion::estadisticas
+};
+
+// Encadena lexer, parser y generador. Es el contexto de un trabajador (un
+// hilo de compilarLote, una conexión del servidor): conserva los tokens, el
+// árbol, la tabla de símbolos, las pilas de cada fase y los buffers de salida
+// entre compilaciones, que solo los vacían. Con programas de tamaño parecido
+// una compilación ya no reserva memoria (--stats lo cuenta).
+class Compilador {
+public:
+    explicit Compilador(const OpcionesCompilacion& opciones = OpcionesCompilacion());
+
+    // Compila `fuente` escribiendo el C++ en `salida`. Lanza runtime_error.
+    // `fuente` también puede ser un árbol serializado (serializer.h): se
+    // genera directamente, sin análisis, y debe estar alineado a 4 bytes.
+    void compilar(string_view fuente, Emisor& salida);
+    // Compila en memoria y devuelve el C++ generado.
+    string compilar(string_view fuente);
+    // Igual, en el buffer del propio compilador: el texto vale hasta la
+    // siguiente llamada. Es lo que usan el servidor y la interfaz C.
+    string_view compilarEnBuffer(string_view fuente);
+    // Analiza `fuente` (o carga el árbol serializado) y lo ejecuta con el
+    // intérprete en vez de generar C++ (interpreter.h). Lanza runtime_error.
+    void ejecutar(string_view fuente, istream& entrada, ostream& salida,
+                  const OpcionesEjecucion& ejecucion = OpcionesEjecucion());
+    // Compila un .pseudo (o un .ast) y guarda el .cpp con el criterio de guardarArchivo.
+    ResultadoCompilacion compilarArchivo(const string& filename);
+    // Medidas de la última compilación (vacías si no se piden estadísticas)
+    const EstadisticasCompilacion& estadisticas() const { return medidas; }
+
+private:
+    void compilarPorFases(string_view fuente, Emisor& salida);
+    void compilarArbolSerializado(string_view datos, Emisor& salida);
+    // Última fase: el C++ o, con emitirAST, el árbol serializado
+    void generar(Emisor& salida);
+
+    OpcionesCompilacion opciones;
+    BufferTokens tokens; // solo con caché o estadísticas: la huella necesita el flujo completo
+    TablaSimbolos simbolos; // de la compilación en curso (se vacía en cada una)
+    ArbolAST arbol;
+    MemoriaParser memoriaParser;
+    MemoriaTipos memoriaTipos;
+    MemoriaGenerador memoriaGenerador;
+    Emisor salidaArchivo;
+    Emisor salidaMemoria;
+    EstadisticasCompilacion medidas;
+};
+
+// Compila `fuente` en memoria con un Compilador de un solo uso. Para muchas
+// compilaciones seguidas conviene conservar un Compilador.
+string compilarPseudocodigo(string_view fuente, const OpcionesCompilacion& opciones = OpcionesCompilacion());
+
+// Compila `entradas` repartiéndolas entre `hilos` trabajadores, cada uno con
+// su propio Compilador. Los resultados siguen el orden de `entradas`; las
+// entradas que comparten archivo de salida se compilan en orden en el mismo
+// trabajador, así el resultado no depende de la planificación.
+vector<ResultadoCompilacion> compilarLote(const vector<string>& entradas,
+                                          const OpcionesCompilacion& opciones, unsigned hilos);
+
+// Expande las entradas del modo por lotes: los directorios aportan sus
+// archivos .pseudo (ordenados) y cada línea de un manifiesto es una ruta
+// (se ignoran las vacías y las que empiezan por '#').
+vector<string> expandirEntradas(const vector<string>& rutas, const vector<string>& manifiestos);
+
+#endif
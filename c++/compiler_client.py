@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Cliente del modo servidor de proyecto_compiladores.
+
+Mantiene el compilador vivo (``--servidor`` por stdin/stdout o ``--socket``)
+y compila pseudocódigo en memoria, sin escribir input.pseudo ni leer el .cpp.
+
+Protocolo: petición = uint32 longitud (little-endian) + pseudocódigo;
+respuesta = uint8 estado (0 ok, 1 error) + uint32 longitud + C++ o mensaje.
+
+La petición también puede ser un árbol ya analizado (``bytes`` de un .ast o
+de ``analizar``), que el compilador genera sin volver a analizar.
+"""
+import socket
+import struct
+import subprocess
+
+
+class ErrorCompilacion(Exception):
+    """El compilador respondió con un error."""
+
+
+def _leer_exacto(leer, n):
+    datos = b""
+    while len(datos) < n:
+        bloque = leer(n - len(datos))
+        if not bloque:
+            raise ConnectionError("El compilador cerró la conexión")
+        datos += bloque
+    return datos
+
+
+def _intercambiar(escribir, leer, entrada):
+    carga = entrada.encode("utf-8") if isinstance(entrada, str) else bytes(entrada)
+    escribir(struct.pack("<I", len(carga)) + carga)
+    estado, longitud = struct.unpack("<BI", _leer_exacto(leer, 5))
+    respuesta = _leer_exacto(leer, longitud)
+    if estado != 0:
+        raise ErrorCompilacion(respuesta.decode("utf-8", errors="replace"))
+    return respuesta
+
+
+def _texto(respuesta):
+    return respuesta.decode("utf-8", errors="replace")
+
+
+class CompiladorResidente:
+    """Lanza ``proyecto_compiladores --servidor`` una vez y reutiliza el proceso.
+
+    Con ``incremental=True`` cada petición se trata como una nueva versión del
+    mismo programa y el servidor solo recompila las sentencias que cambiaron
+    (útil en ciclos de edición y compilación).
+
+    Con ``emitir_ast=True`` el servidor responde con el árbol analizado en
+    vez del C++: ``analizar`` devuelve esos bytes, que luego se pueden pasar
+    a ``compilar`` de cualquier compilador residente.
+    """
+
+    def __init__(self, compiler_path="./build/proyecto_compiladores", ignorar_mayusculas=True,
+                 incremental=False, emitir_ast=False):
+        args = [compiler_path, "--servidor"]
+        if emitir_ast:
+            args.insert(1, "--ast")
+        if incremental:
+            args.insert(1, "--incremental")
+        if ignorar_mayusculas:
+            args.insert(1, "--ignorar-mayusculas")
+        self.proceso = subprocess.Popen(args, stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+
+    def _escribir(self, datos):
+        self.proceso.stdin.write(datos)
+        self.proceso.stdin.flush()
+
+    def compilar(self, pseudocodigo):
+        """Devuelve el C++ generado; lanza ErrorCompilacion si falla."""
+        return _texto(_intercambiar(self._escribir, self.proceso.stdout.read, pseudocodigo))
+
+    def analizar(self, pseudocodigo):
+        """Con ``emitir_ast=True``: devuelve el árbol serializado (bytes)."""
+        return _intercambiar(self._escribir, self.proceso.stdout.read, pseudocodigo)
+
+    def cerrar(self):
+        if self.proceso.poll() is None:
+            self.proceso.stdin.close()
+            self.proceso.wait()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.cerrar()
+
+
+class ClienteSocket:
+    """Conexión a un ``proyecto_compiladores --socket <ruta>`` ya en marcha."""
+
+    def __init__(self, ruta):
+        self.conexion = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.conexion.connect(ruta)
+
+    def compilar(self, pseudocodigo):
+        """Devuelve el C++ generado; lanza ErrorCompilacion si falla."""
+        return _texto(_intercambiar(self.conexion.sendall, self.conexion.recv, pseudocodigo))
+
+    def cerrar(self):
+        self.conexion.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.cerrar()
@@ -0,0 +1,33 @@
+// Reemplazo del operador new global para contar reservas en --stats. Solo se
+// enlaza en el ejecutable: la biblioteca no impone su operador new a quien la use.
+// Desactivado cuesta una lectura atómica relajada por reserva.
+#include <cstdlib>
+#include <new>
+#include "stats.h"
+
+using namespace std;
+
+namespace {
+
+const bool declarado = (declararContadorMemoria(), true);
+
+} // namespace
+
+void* operator new(size_t bytes) {
+    if (contadorMemoriaActivo()) registrarReserva(bytes);
+    if (bytes == 0) bytes = 1;
+    for (;;) {
+        if (void* memoria = malloc(bytes)) return memoria;
+        new_handler manejador = get_new_handler();
+        if (!manejador) throw bad_alloc();
+        manejador();
+    }
+}
+
+void operator delete(void* memoria) noexcept {
+    free(memoria);
+}
+
+void operator delete(void* memoria, size_t) noexcept {
+    free(memoria);
+}
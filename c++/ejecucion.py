@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Ejecución inmediata del pseudocódigo dictado, en dos niveles.
+
+Primero con el intérprete del compilador (``--ejecutar``): sin generar C++ ni
+esperar a g++, el programa corre al momento. Si pasa de ``limite_pasos`` es de
+los que tardan: se genera el C++, se compila con g++ -O2 y se vuelve a
+ejecutar desde el principio (la salida del intérprete hasta ahí ya se vio).
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+PASOS_INTERPRETE = 20_000_000
+# Código de salida de --ejecutar al llegar a --limite-pasos
+LIMITE_ALCANZADO = 3
+
+
+def compilar_y_ejecutar(pseudo_file, compiler_path="./build/proyecto_compiladores"):
+    """Nivel compilado: C++ generado + g++ -O2 + el ejecutable."""
+    base = os.path.splitext(os.path.basename(pseudo_file))[0]
+    cpp_file = base + ".cpp"
+    generado = subprocess.run([compiler_path, "--ignorar-mayusculas", "--stdout", pseudo_file],
+                              capture_output=True, text=True)
+    if generado.returncode != 0:
+        print("Error en la compilación:")
+        print(generado.stderr)
+        return generado.returncode
+    with open(cpp_file, "w") as f:
+        f.write(generado.stdout)
+    compilado = subprocess.run(["g++", "-O2", "-o", base, cpp_file])
+    if compilado.returncode != 0:
+        print(f"g++ no pudo compilar {cpp_file}")
+        return compilado.returncode
+    return subprocess.run([os.path.abspath(base)]).returncode
+
+
+def ejecutar_pseudocodigo(pseudo_file, compiler_path="./build/proyecto_compiladores",
+                          limite_pasos=PASOS_INTERPRETE):
+    """Ejecuta el programa leyendo y escribiendo en la terminal; devuelve su código de salida."""
+    try:
+        resultado = subprocess.run([compiler_path, "--ignorar-mayusculas", "--ejecutar",
+                                    "--limite-pasos", str(limite_pasos), pseudo_file])
+    except OSError as e:
+        print(f"Error al ejecutar el compilador: {e}")
+        return 1
+    if resultado.returncode != LIMITE_ALCANZADO:
+        return resultado.returncode
+    print("El programa tarda: se compila con g++ y se ejecuta de nuevo desde el principio...")
+    return compilar_y_ejecutar(pseudo_file, compiler_path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Ejecuta un programa de pseudocódigo al momento")
+    parser.add_argument("archivo", help="Archivo .pseudo")
+    parser.add_argument("--compiler", type=str, default="./build/proyecto_compiladores", help="Ejecutable del compilador")
+    parser.add_argument("--limite-pasos", type=int, default=PASOS_INTERPRETE,
+                        help="Pasos del intérprete antes de pasar a g++")
+    args = parser.parse_args()
+    sys.exit(ejecutar_pseudocodigo(args.archivo, args.compiler, args.limite_pasos))
+
+
+if __name__ == "__main__":
+    main()
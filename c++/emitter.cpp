@@ -0,0 +1,63 @@
+#include "emitter.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+const char ESPACIOS[] =
+    "                                                                "
+    "                                                                ";
+const int NUM_ESPACIOS = sizeof(ESPACIOS) - 1;
+
+} // namespace
+
+Emisor::Emisor() : destino(nullptr), error(false), escritos(0) {}
+
+Emisor::Emisor(FILE* destino) : destino(destino), error(false), escritos(0) {
+    buffer.reserve(TAM_BLOQUE);
+}
+
+Emisor::~Emisor() {
+    vaciar();
+}
+
+Emisor& Emisor::operator<<(Sangria sangria) {
+    for (int resto = sangria.columnas; resto > 0; resto -= NUM_ESPACIOS) {
+        escribir(ESPACIOS, min(resto, NUM_ESPACIOS));
+    }
+    return *this;
+}
+
+void Emisor::escribir(const char* datos, size_t n) {
+    escritos += n;
+    if (destino && buffer.size() + n > TAM_BLOQUE) {
+        vaciar();
+        if (n >= TAM_BLOQUE) {
+            if (fwrite(datos, 1, n, destino) != n) error = true;
+            return;
+        }
+    }
+    buffer.append(datos, n);
+}
+
+void Emisor::vaciar() {
+    if (!destino) return;
+    if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), destino) != buffer.size()) {
+        error = true;
+    }
+    buffer.clear();
+    if (fflush(destino) != 0) error = true;
+}
+
+void Emisor::cambiarDestino(FILE* nuevo) {
+    vaciar();
+    destino = nuevo;
+    error = false;
+}
+
+string Emisor::tomarTexto() {
+    string texto = move(buffer);
+    buffer.clear();
+    return texto;
+}
@@ -0,0 +1,61 @@
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Sangría de `columnas` espacios, escrita desde un buffer estático.
+struct Sangria {
+    int columnas;
+};
+
+// Buffer de salida reutilizable. Con un FILE* de destino se vuelca en bloques
+// de TAM_BLOQUE bytes, así la memoria no crece con el tamaño del código
+// generado; sin destino todo queda en memoria y se recupera con tomarTexto().
+class Emisor {
+public:
+    static constexpr size_t TAM_BLOQUE = 64 * 1024;
+
+    Emisor();
+    explicit Emisor(FILE* destino);
+    ~Emisor();
+
+    Emisor(const Emisor&) = delete;
+    Emisor& operator=(const Emisor&) = delete;
+
+    Emisor& operator<<(string_view texto) {
+        escribir(texto.data(), texto.size());
+        return *this;
+    }
+    Emisor& operator<<(const char* texto) { return *this << string_view(texto); }
+    Emisor& operator<<(char c) { return *this << string_view(&c, 1); }
+    Emisor& operator<<(Sangria sangria);
+
+    // Escribe en el destino lo pendiente (no hace nada en modo memoria)
+    void vaciar();
+    // Vacía lo pendiente y pasa a escribir en `nuevo` conservando el buffer
+    void cambiarDestino(FILE* nuevo);
+    // Solo en modo memoria: devuelve el texto acumulado y deja el buffer vacío
+    string tomarTexto();
+    // Solo en modo memoria: el texto acumulado, válido hasta la siguiente escritura
+    string_view texto() const { return buffer; }
+    // Descarta lo acumulado sin liberar el buffer
+    void limpiar() { buffer.clear(); }
+    bool fallo() const { return error; }
+    // Bytes escritos desde que se creó el emisor (incluye los ya volcados)
+    uint64_t bytesEscritos() const { return escritos; }
+
+private:
+    void escribir(const char* datos, size_t n);
+
+    FILE* destino;
+    string buffer;
+    bool error;
+    uint64_t escritos;
+};
+
+#endif
@@ -1,155 +1,583 @@
 #include "generator.h"
-#include <sstream>
+#include <algorithm>
+#include <cctype>
 #include <set>
+#include "parallel.h"
+#include "thread_pool.h"
+#include "types.h"
 
 using namespace std;
 
+namespace {
+
+// Con --fast-io=buffer: lector y escritor con buffer propio que reemplazan a
+// cin/cout con la misma sintaxis (>> y <<). El escritor vacía al destruirse,
+// al terminar el programa.
+const char ES_CON_BUFFER[] =
+    "class LectorRapido {\n"
+    "public:\n"
+    "    LectorRapido& operator>>(long long& x) {\n"
+    "        int c = saltarEspacios();\n"
+    "        bool negativo = c == '-';\n"
+    "        if (negativo || c == '+') c = siguiente();\n"
+    "        x = 0;\n"
+    "        while (c >= '0' && c <= '9') {\n"
+    "            x = x * 10 + (c - '0');\n"
+    "            c = siguiente();\n"
+    "        }\n"
+    "        devolver(c);\n"
+    "        if (negativo) x = -x;\n"
+    "        return *this;\n"
+    "    }\n"
+    "    LectorRapido& operator>>(int& x) { long long v; *this >> v; x = (int)v; return *this; }\n"
+    "    LectorRapido& operator>>(bool& x) { long long v; *this >> v; x = v != 0; return *this; }\n"
+    "    LectorRapido& operator>>(double& x) { string t; *this >> t; x = strtod(t.c_str(), nullptr); return *this; }\n"
+    "    LectorRapido& operator>>(string& x) {\n"
+    "        x.clear();\n"
+    "        int c = saltarEspacios();\n"
+    "        while (c != EOF && !isspace(c)) {\n"
+    "            x += (char)c;\n"
+    "            c = siguiente();\n"
+    "        }\n"
+    "        devolver(c);\n"
+    "        return *this;\n"
+    "    }\n"
+    "\n"
+    "private:\n"
+    "    int siguiente() {\n"
+    "        if (pos == fin) {\n"
+    "            fin = fread(buffer, 1, sizeof(buffer), stdin);\n"
+    "            pos = 0;\n"
+    "            if (fin == 0) return EOF;\n"
+    "        }\n"
+    "        return (unsigned char)buffer[pos++];\n"
+    "    }\n"
+    "    void devolver(int c) { if (c != EOF) pos--; }\n"
+    "    int saltarEspacios() {\n"
+    "        int c = siguiente();\n"
+    "        while (c != EOF && isspace(c)) c = siguiente();\n"
+    "        return c;\n"
+    "    }\n"
+    "\n"
+    "    char buffer[1 << 16];\n"
+    "    size_t pos = 0;\n"
+    "    size_t fin = 0;\n"
+    "};\n"
+    "\n"
+    "class EscritorRapido {\n"
+    "public:\n"
+    "    ~EscritorRapido() { vaciar(); }\n"
+    "    void vaciar() {\n"
+    "        fwrite(buffer, 1, usado, stdout);\n"
+    "        usado = 0;\n"
+    "        fflush(stdout);\n"
+    "    }\n"
+    "    EscritorRapido& operator<<(const char* s) { escribir(s, strlen(s)); return *this; }\n"
+    "    EscritorRapido& operator<<(const string& s) { escribir(s.data(), s.size()); return *this; }\n"
+    "    EscritorRapido& operator<<(char c) { escribir(&c, 1); return *this; }\n"
+    "    EscritorRapido& operator<<(bool b) { return *this << (b ? '1' : '0'); }\n"
+    "    EscritorRapido& operator<<(int x) { return *this << (long long)x; }\n"
+    "    EscritorRapido& operator<<(long long x) {\n"
+    "        char digitos[24];\n"
+    "        int n = 0;\n"
+    "        unsigned long long v = x < 0 ? 0ull - (unsigned long long)x : (unsigned long long)x;\n"
+    "        do {\n"
+    "            digitos[n++] = (char)('0' + v % 10);\n"
+    "            v /= 10;\n"
+    "        } while (v > 0);\n"
+    "        if (x < 0) digitos[n++] = '-';\n"
+    "        while (n > 0) *this << digitos[--n];\n"
+    "        return *this;\n"
+    "    }\n"
+    "    EscritorRapido& operator<<(double x) {\n"
+    "        char texto[32];\n"
+    "        escribir(texto, snprintf(texto, sizeof(texto), \"%g\", x));\n"
+    "        return *this;\n"
+    "    }\n"
+    "\n"
+    "private:\n"
+    "    void escribir(const char* datos, size_t n) {\n"
+    "        if (usado + n > sizeof(buffer)) vaciar();\n"
+    "        if (n > sizeof(buffer)) {\n"
+    "            fwrite(datos, 1, n, stdout);\n"
+    "            return;\n"
+    "        }\n"
+    "        memcpy(buffer + usado, datos, n);\n"
+    "        usado += n;\n"
+    "    }\n"
+    "\n"
+    "    char buffer[1 << 16];\n"
+    "    size_t usado = 0;\n"
+    "};\n"
+    "\n"
+    "static LectorRapido lectorRapido;\n"
+    "static EscritorRapido escritorRapido;\n"
+    "\n";
+
+} // namespace
+
 class CodeGenerator {
 public:
-    ostringstream codigo;
+    const ArbolAST& arbol;
+    Emisor& codigo;
     int indentLevel;
-    set<string> declaredVars;
+    MemoriaGenerador& memoria;
+    ConjuntoSimbolos& declaredVars; // por id de símbolo
+    OpcionesCodigo opciones;
+    bool enParalelo; // dentro de un bucle ya paralelizado: no se anidan regiones
+    vector<Reduccion>& reducciones;
+    
+    // Cada generador empieza con la memoria vacía: las unidades de un programa
+    // la usan una tras otra
+    CodeGenerator(const ArbolAST& a, Emisor& salida, const OpcionesCodigo& opciones, MemoriaGenerador& memoria)
+        : arbol(a), codigo(salida), indentLevel(0), memoria(memoria), declaredVars(memoria.declaradas),
+          opciones(opciones), enParalelo(false), reducciones(memoria.reducciones) {
+        declaredVars.limpiar();
+        reducciones.clear();
+    }
+    
+    const char* flujoSalida() const {
+        return opciones.entradaSalida == ModoES::BUFFER ? "escritorRapido" : "cout";
+    }
+    
+    const char* flujoEntrada() const {
+        return opciones.entradaSalida == ModoES::BUFFER ? "lectorRapido" : "cin";
+    }
+    
+    Sangria indent() {
+        return Sangria{indentLevel * 4};
+    }
+    
+    void includes() {
+        if (opciones.entradaSalida == ModoES::BUFFER) {
+            codigo << "#include <cctype>\n";
+            codigo << "#include <cstdio>\n";
+            codigo << "#include <cstdlib>\n";
+            codigo << "#include <cstring>\n";
+        }
+        codigo << "#include <iostream>\n";
+        codigo << "#include <string>\n";
+        codigo << "#include <vector>\n";
+        codigo << "using namespace std;\n\n";
+        if (opciones.entradaSalida == ModoES::BUFFER) {
+            codigo << ES_CON_BUFFER;
+        }
+    }
+    
+    void inicioMain() {
+        codigo << "int main() {\n";
+        if (opciones.entradaSalida == ModoES::RAPIDA) {
+            codigo << "    ios::sync_with_stdio(false);\n";
+            codigo << "    cin.tie(nullptr);\n";
+        }
+    }
     
-    CodeGenerator() : indentLevel(0) {}
+    void finMain() {
+        codigo << indent() << "return 0;\n";
+        codigo << "}\n";
+    }
     
-    string indent() {
-        return string(indentLevel * 4, ' ');
+    // Declaración con valor inicial (las variables de Definir y de retorno)
+    void declararVariable(string_view nombre, TipoDato tipo) {
+        codigo << indent() << tipoCpp(tipo) << " " << nombre;
+        if (tipo == TipoDato::LOGICO) {
+            codigo << " = false";
+        } else if (tipo != TipoDato::CADENA) {
+            codigo << " = 0";
+        }
+        codigo << ";\n";
     }
     
-    void generateNode(NodoAST* nodo) {
-        if (!nodo) return;
+    // int suma(int a, vector<double>& v, string& s): los arreglos y los Por
+    // Referencia se pasan por referencia
+    void cabeceraFuncion(NodoId id) {
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        codigo << (hijos.size() > 2 ? tipoCpp(nodo.tipoDato) : string_view("void")) << " " << nodo.valor << "(";
+        const char* separador = "";
+        for (NodoId parametro : arbol.hijosDe(hijos[0])) {
+            const NodoAST& datos = arbol[parametro];
+            codigo << separador;
+            if (datos.arreglo) {
+                codigo << "vector<" << tipoCpp(datos.tipoDato) << ">& ";
+            } else {
+                codigo << tipoCpp(datos.tipoDato) << (datos.numHijos > 0 ? "& " : " ");
+            }
+            codigo << datos.valor;
+            separador = ", ";
+        }
+        codigo << ")";
+    }
+    
+    // Cada función es su propio ámbito: empieza con los parámetros y la
+    // variable de retorno ya declarados
+    void generarFuncion(NodoId id) {
+        RangoHijos hijos = arbol.hijosDe(id);
+        cabeceraFuncion(id);
+        codigo << " {\n";
+        indentLevel++;
+        for (NodoId parametro : arbol.hijosDe(hijos[0])) {
+            declarar(arbol[parametro].simbolo);
+        }
+        NodoId retorno = hijos.size() > 2 ? hijos[2] : NODO_NULO;
+        if (retorno != NODO_NULO && declarar(arbol[retorno].simbolo)) {
+            declararVariable(arbol[retorno].valor, arbol[id].tipoDato);
+        }
+        generateNode(hijos[1]);
+        if (retorno != NODO_NULO) codigo << indent() << "return " << arbol[retorno].valor << ";\n";
+        indentLevel--;
+        codigo << "}\n";
+    }
+    
+    // Las sentencias se escriben solas salvo la llamada, que también puede ir
+    // dentro de una expresión
+    void generarSentencia(NodoId id) {
+        if (id != NODO_NULO && arbol[id].tipo == TipoNodo::LLAMADA) {
+            codigo << indent();
+            generateNode(id);
+            codigo << ";\n";
+            return;
+        }
+        generateNode(id);
+    }
+    
+    // Prototipos, y el algoritmo y las funciones en el orden del programa
+    void generarPrograma(NodoId id) {
+        RangoHijos unidades = arbol.hijosDe(id);
+        includes();
+        bool hayFunciones = false;
+        for (NodoId unidad : unidades) {
+            if (arbol[unidad].tipo != TipoNodo::FUNCION) continue;
+            cabeceraFuncion(unidad);
+            codigo << ";\n";
+            hayFunciones = true;
+        }
+        if (hayFunciones) codigo << "\n";
         
-        if (nodo->tipo == "PROGRAMA") {
-            codigo << "#include <iostream>\n";
-            codigo << "#include <string>\n";
-            codigo << "using namespace std;\n\n";
-            
-            for (auto hijo : nodo->hijos) {
-                generateNode(hijo);
+        if (opciones.hilos <= 1 || unidades.size() < 2) {
+            for (size_t u = 0; u < unidades.size(); u++) {
+                if (u > 0) codigo << "\n";
+                CodeGenerator unidad(arbol, codigo, opciones, memoria);
+                unidad.generateNode(unidades[u]);
             }
+            return;
         }
-        else if (nodo->tipo == "ALGORITMO") {
-            codigo << "int main() {\n";
+        
+        // Sin estado compartido: cada unidad tiene su generador y su buffer
+        vector<unique_ptr<Emisor>> textos(unidades.size());
+        ejecutarConRobo(unidades.size(), opciones.hilos, [&](unsigned, size_t u) {
+            textos[u] = make_unique<Emisor>();
+            MemoriaGenerador propia;
+            CodeGenerator unidad(arbol, *textos[u], opciones, propia);
+            unidad.generateNode(unidades[u]);
+        });
+        for (size_t u = 0; u < unidades.size(); u++) {
+            if (u > 0) codigo << "\n";
+            codigo << textos[u]->tomarTexto();
+        }
+    }
+    
+    // Paréntesis solo donde C++ agruparía distinto que el árbol: operandos de
+    // menor precedencia, o de igual precedencia a la derecha (a - (b - c)).
+    void generarOperando(NodoId id, uint8_t nivelPadre, bool derecho) {
+        const NodoAST& nodo = arbol[id];
+        uint8_t nivel = nodo.tipo == TipoNodo::OPERACION_BINARIA ? precedencia(nodo.operador) : UINT8_MAX;
+        bool parentesis = nivel < nivelPadre || (derecho && nivel == nivelPadre);
+        if (parentesis) codigo << "(";
+        generateNode(id);
+        if (parentesis) codigo << ")";
+    }
+    
+    // true (y la marca como declarada) si la variable todavía no tiene declaración
+    bool declarar(SimboloId simbolo) {
+        return declaredVars.insertar(simbolo);
+    }
+    
+    // Pragma de OpenMP delante de un Para (--paralelizar, --vectorizar); sin
+    // -fopenmp el compilador de C++ lo ignora y el bucle es el de siempre.
+    // `paralelo` indica si el pragma abre una región paralela.
+    bool pragmaBucle(NodoId para, bool& paralelo) {
+        paralelo = false;
+        if (!opciones.paralelizar && !opciones.vectorizar) return false;
+        if (!analizarParalelismo(arbol, para, declaredVars, reducciones, memoria.paralelismo)) return false;
+        paralelo = opciones.paralelizar && !enParalelo;
+        bool simd = opciones.vectorizar && cuerpoLineal(arbol, para);
+        if (!paralelo && !simd) return false;
+        codigo << indent() << "#pragma omp " << (paralelo ? (simd ? "parallel for simd" : "parallel for") : "simd");
+        for (char operador : {'+', '*'}) {
+            const char* separador = "";
+            for (const Reduccion& reduccion : reducciones) {
+                if (reduccion.operador != operador) continue;
+                if (*separador == 0) codigo << " reduction(" << operador << ":";
+                codigo << separador << reduccion.variable;
+                separador = ", ";
+            }
+            if (*separador != 0) codigo << ")";
+        }
+        codigo << "\n";
+        return true;
+    }
+    
+    // El Hasta se evalúa una sola vez, en `nombre`, si no es un literal, el
+    // cuerpo no lo modifica y su tipo cabe en el del contador
+    bool sacarLimite(NodoId para, string& nombre) {
+        RangoHijos hijos = arbol.hijosDe(para);
+        if (hijos.size() < 3 || arbol[hijos[1]].tipo == TipoNodo::NUMERO) return false;
+        // tipoCpp declara int lo que no tiene tipo, y bool cabe en int
+        TipoDato contador = max(arbol[para].tipoDato, TipoDato::ENTERO);
+        TipoDato hasta = max(arbol[hijos[1]].tipoDato, TipoDato::ENTERO);
+        if (hasta > contador || !limiteInvariante(arbol, para, memoria.paralelismo)) return false;
+        nombre.assign(arbol[para].valor);
+        nombre += "_fin";
+        return !usaNombre(arbol, para, nombre);
+    }
+    
+    void generateNode(NodoId id) {
+        if (id == NODO_NULO) return;
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        
+        switch (nodo.tipo) {
+        case TipoNodo::PROGRAMA: {
+            generarPrograma(id);
+            break;
+        }
+        case TipoNodo::ALGORITMO: {
+            inicioMain();
             indentLevel++;
             
-            for (auto hijo : nodo->hijos) {
-                generateNode(hijo);
+            for (NodoId hijo : hijos) {
+                generarSentencia(hijo);
             }
             
             indentLevel--;
-            codigo << indent() << "return 0;\n";
-            codigo << "}\n";
+            finMain();
+            break;
         }
-        else if (nodo->tipo == "ESCRIBIR") {
-            codigo << indent() << "cout << ";
-            if (!nodo->hijos.empty()) {
-                generateNode(nodo->hijos[0]);
+        case TipoNodo::ESCRIBIR: {
+            codigo << indent() << flujoSalida() << " << ";
+            if (!hijos.empty()) {
+                // << agrupa antes que las comparaciones: Escribir a < b necesita paréntesis
+                generarOperando(hijos[0], precedencia(Operador::MENOR) + 1, false);
             }
-            codigo << " << endl;\n";
+            // '\n' en vez de endl: la salida se vacía una sola vez, al terminar
+            codigo << " << '\\n';\n";
+            break;
         }
-        else if (nodo->tipo == "LEER") {
-            codigo << indent() << "cin >> ";
-            if (!nodo->hijos.empty()) {
-                generateNode(nodo->hijos[0]);
+        case TipoNodo::LEER: {
+            // Leer puede ser el primer uso de la variable
+            if (!hijos.empty() && arbol[hijos[0]].tipo == TipoNodo::IDENTIFICADOR && declarar(arbol[hijos[0]].simbolo)) {
+                codigo << indent() << tipoCpp(nodo.tipoDato) << " " << arbol[hijos[0]].valor << ";\n";
+            }
+            codigo << indent() << flujoEntrada() << " >> ";
+            if (!hijos.empty()) {
+                generateNode(hijos[0]);
             }
             codigo << ";\n";
+            break;
         }
-        else if (nodo->tipo == "SI") {
+        case TipoNodo::SI: {
             codigo << indent() << "if (";
-            if (!nodo->hijos.empty()) {
-                generateNode(nodo->hijos[0]); // condición
+            if (!hijos.empty()) {
+                generateNode(hijos[0]); // condición
             }
             codigo << ") {\n";
             
             indentLevel++;
-            if (nodo->hijos.size() > 1) {
-                generateNode(nodo->hijos[1]); // bloque then
+            if (hijos.size() > 1) {
+                generateNode(hijos[1]); // bloque then
             }
             indentLevel--;
             
             codigo << indent() << "}";
             
-            if (nodo->hijos.size() > 2) { // bloque else
+            if (hijos.size() > 2) { // bloque else
                 codigo << " else {\n";
                 indentLevel++;
-                generateNode(nodo->hijos[2]);
+                generateNode(hijos[2]);
                 indentLevel--;
                 codigo << indent() << "}";
             }
             codigo << "\n";
+            break;
         }
-        else if (nodo->tipo == "PARA") {
-            codigo << indent() << "for (int " << nodo->valor << " = ";
-            if (!nodo->hijos.empty()) {
-                generateNode(nodo->hijos[0]); // inicio
+        case TipoNodo::PARA: {
+            bool paralelo;
+            // OpenMP exige la forma canónica del for: con pragma el límite queda en la condición.
+            // Solo se usa antes del cuerpo: los Para anidados comparten el texto
+            string& limite = memoria.limite;
+            bool sacar = !pragmaBucle(id, paralelo) && sacarLimite(id, limite);
+            codigo << indent() << "for (" << tipoCpp(nodo.tipoDato) << " " << nodo.valor << " = ";
+            if (!hijos.empty()) {
+                generateNode(hijos[0]); // inicio
             }
-            codigo << "; " << nodo->valor << " <= ";
-            if (nodo->hijos.size() > 1) {
-                generateNode(nodo->hijos[1]); // fin
+            if (sacar) {
+                codigo << ", " << limite << " = ";
+                generateNode(hijos[1]);
             }
-            codigo << "; " << nodo->valor << "++) {\n";
+            codigo << "; " << nodo.valor << " <= ";
+            if (sacar) {
+                codigo << limite;
+            } else if (hijos.size() > 1) {
+                generateNode(hijos[1]); // fin
+            }
+            codigo << "; " << nodo.valor << "++) {\n";
             
             indentLevel++;
-            if (nodo->hijos.size() > 2) {
-                generateNode(nodo->hijos[2]); // bloque
+            if (paralelo) enParalelo = true;
+            if (hijos.size() > 2) {
+                generateNode(hijos[2]); // bloque
             }
+            if (paralelo) enParalelo = false;
             indentLevel--;
             
             codigo << indent() << "}\n";
+            break;
         }
-        else if (nodo->tipo == "MIENTRAS") {
+        case TipoNodo::MIENTRAS: {
             codigo << indent() << "while (";
-            if (!nodo->hijos.empty()) {
-                generateNode(nodo->hijos[0]); // condición
+            if (!hijos.empty()) {
+                generateNode(hijos[0]); // condición
             }
             codigo << ") {\n";
             
             indentLevel++;
-            if (nodo->hijos.size() > 1) {
-                generateNode(nodo->hijos[1]); // bloque
+            if (hijos.size() > 1) {
+                generateNode(hijos[1]); // bloque
             }
             indentLevel--;
             
             codigo << indent() << "}\n";
+            break;
         }
-        else if (nodo->tipo == "ASIGNACION") {
-            if (declaredVars.find(nodo->valor) == declaredVars.end()) {
-                codigo << indent() << "int " << nodo->valor << " = ";
-                declaredVars.insert(nodo->valor);
+        case TipoNodo::ASIGNACION: {
+            if (hijos.size() > 1) { // a[i] <- expr
+                codigo << indent() << nodo.valor << "[";
+                generateNode(hijos[1]);
+                codigo << "] = ";
+            } else if (declarar(nodo.simbolo)) {
+                codigo << indent() << tipoCpp(nodo.tipoDato) << " " << nodo.valor << " = ";
             } else {
-                codigo << indent() << nodo->valor << " = ";
+                codigo << indent() << nodo.valor << " = ";
             }
-            if (!nodo->hijos.empty()) {
-                generateNode(nodo->hijos[0]);
+            if (!hijos.empty()) {
+                generateNode(hijos[0]);
             }
             codigo << ";\n";
+            break;
+        }
+        case TipoNodo::BLOQUE: {
+            for (NodoId hijo : hijos) {
+                generarSentencia(hijo);
+            }
+            break;
+        }
+        case TipoNodo::NUMERO: {
+            codigo << nodo.valor;
+            break;
+        }
+        case TipoNodo::CADENA: {
+            codigo << "\"" << nodo.valor << "\"";
+            break;
+        }
+        case TipoNodo::IDENTIFICADOR: {
+            codigo << nodo.valor;
+            break;
         }
-        else if (nodo->tipo == "BLOQUE") {
-            for (auto hijo : nodo->hijos) {
-                generateNode(hijo);
+        case TipoNodo::OPERACION_BINARIA: {
+            if (hijos.size() >= 2) {
+                uint8_t nivel = precedencia(nodo.operador);
+                generarOperando(hijos[0], nivel, false);
+                codigo << " " << nodo.valor << " ";
+                generarOperando(hijos[1], nivel, true);
             }
+            break;
         }
-        else if (nodo->tipo == "NUMERO") {
-            codigo << nodo->valor;
+        case TipoNodo::EXPRESION:
+            // Verdadero o Falso (el parser no deja otra cosa en una hoja EXPRESION)
+            codigo << (!nodo.valor.empty() && tolower((unsigned char)nodo.valor[0]) == 'v' ? "true" : "false");
+            break;
+        case TipoNodo::DECLARACION: {
+            // La de un arreglo la escribe su Dimension
+            if (!declarar(nodo.simbolo) || nodo.arreglo) break;
+            declararVariable(nodo.valor, nodo.tipoDato);
+            break;
         }
-        else if (nodo->tipo == "CADENA") {
-            codigo << "\"" << nodo->valor << "\"";
+        case TipoNodo::DIMENSION: {
+            // PSeInt no redimensiona: siempre es la declaración. Tamaño n + 1:
+            // índices de 1 a n como en PSeInt (y el 0 también vale)
+            declarar(nodo.simbolo);
+            codigo << indent() << "vector<" << tipoCpp(nodo.tipoDato) << "> " << nodo.valor << "(";
+            if (!hijos.empty()) {
+                generarOperando(hijos[0], precedencia(Operador::SUMA), false);
+                codigo << " + ";
+            }
+            codigo << "1);\n";
+            break;
         }
-        else if (nodo->tipo == "IDENTIFICADOR") {
-            codigo << nodo->valor;
+        case TipoNodo::ELEMENTO: {
+            codigo << nodo.valor << "[";
+            if (!hijos.empty()) {
+                generateNode(hijos[0]);
+            }
+            codigo << "]";
+            break;
         }
-        else if (nodo->tipo == "OPERACION_BINARIA") {
-            if (nodo->hijos.size() >= 2) {
-                generateNode(nodo->hijos[0]);
-                codigo << " " << nodo->valor << " ";
-                generateNode(nodo->hijos[1]);
+        case TipoNodo::FUNCION:
+            generarFuncion(id);
+            break;
+        case TipoNodo::PARAMETRO:
+            break;
+        case TipoNodo::LLAMADA: {
+            codigo << nodo.valor << "(";
+            for (size_t i = 0; i < hijos.size(); i++) {
+                if (i > 0) codigo << ", ";
+                generateNode(hijos[i]);
             }
+            codigo << ")";
+            break;
+        }
         }
     }
 };
 
-string generarCodigo(NodoAST* arbol) {
-    CodeGenerator generator;
-    generator.generateNode(arbol);
-    return generator.codigo.str();
+void generarCodigo(const ArbolAST& arbol, Emisor& salida, const OpcionesCodigo& opciones) {
+    MemoriaGenerador memoria;
+    generarCodigo(arbol, salida, opciones, memoria);
+}
+
+void generarCodigo(const ArbolAST& arbol, Emisor& salida, const OpcionesCodigo& opciones, MemoriaGenerador& memoria) {
+    CodeGenerator generator(arbol, salida, opciones, memoria);
+    generator.generateNode(arbol.raiz);
+}
+
+void generarPrologo(Emisor& salida, const OpcionesCodigo& opciones) {
+    ArbolAST vacio;
+    MemoriaGenerador memoria;
+    CodeGenerator generator(vacio, salida, opciones, memoria);
+    generator.includes();
+    generator.inicioMain();
+}
+
+void generarSentencia(const ArbolAST& arbol, NodoId sentencia, ConjuntoSimbolos& declaradas, Emisor& salida,
+                      const OpcionesCodigo& opciones) {
+    MemoriaGenerador memoria;
+    CodeGenerator generator(arbol, salida, opciones, memoria);
+    generator.indentLevel = 1;
+    generator.declaredVars.swap(declaradas);
+    generator.generarSentencia(sentencia);
+    generator.declaredVars.swap(declaradas);
+}
+
+void generarEpilogo(Emisor& salida, const OpcionesCodigo& opciones) {
+    ArbolAST vacio;
+    MemoriaGenerador memoria;
+    CodeGenerator generator(vacio, salida, opciones, memoria);
+    generator.finMain();
+}
+
+string generarCodigo(const ArbolAST& arbol, const OpcionesCodigo& opciones) {
+    Emisor salida;
+    generarCodigo(arbol, salida, opciones);
+    return salida.tomarTexto();
 }
\ No newline at end of file
@@ -2,10 +2,53 @@
 #define GENERATOR_H
 
 #include "parser.h"
+#include "emitter.h"
+#include "parallel.h"
 #include <string>
 #include <map>
 
-string generarCodigo(NodoAST* arbol);
+// Entrada/salida de los programas generados
+enum class ModoES : uint8_t {
+    ESTANDAR, // cin/cout tal cual
+    RAPIDA,   // --fast-io: sin sincronizar con stdio y cin sin atar a cout
+    BUFFER    // --fast-io=buffer: lector y escritor propios sobre fread/fwrite
+};
+
+struct OpcionesCodigo {
+    ModoES entradaSalida = ModoES::ESTANDAR;
+    // --paralelizar: #pragma omp parallel for en los Para sin dependencias
+    // entre iteraciones (ver analizarParalelismo)
+    bool paralelizar = false;
+    // --vectorizar: #pragma omp simd en los Para independientes cuyo cuerpo
+    // son solo asignaciones
+    bool vectorizar = false;
+    // Hilos para generar a la vez el algoritmo y los SubProceso, cada uno en
+    // su propio buffer (1 = todo en el hilo que llama). No cambia la salida.
+    unsigned hilos = 1;
+};
+
+// Memoria de trabajo del generador. Un Compilador conserva la suya entre
+// compilaciones, así generar ya no reserva (salvo con hilos > 1).
+struct MemoriaGenerador {
+    ConjuntoSimbolos declaradas;
+    vector<Reduccion> reducciones;
+    MemoriaParalelismo paralelismo;
+    string limite; // variable con el Hasta del Para en curso
+};
+
+string generarCodigo(const ArbolAST& arbol, const OpcionesCodigo& opciones = OpcionesCodigo());
+// Escribe el código directamente en `salida` (por bloques si tiene destino)
+void generarCodigo(const ArbolAST& arbol, Emisor& salida, const OpcionesCodigo& opciones = OpcionesCodigo());
+void generarCodigo(const ArbolAST& arbol, Emisor& salida, const OpcionesCodigo& opciones, MemoriaGenerador& memoria);
+
+// Generación por partes para la compilación incremental: prólogo, cada
+// sentencia del algoritmo en orden y epílogo producen lo mismo que
+// generarCodigo. `declaradas` lleva las variables ya declaradas con tipo
+// (ids de la tabla de símbolos con la que se analizaron todas las sentencias).
+void generarPrologo(Emisor& salida, const OpcionesCodigo& opciones = OpcionesCodigo());
+void generarSentencia(const ArbolAST& arbol, NodoId sentencia, ConjuntoSimbolos& declaradas, Emisor& salida,
+                      const OpcionesCodigo& opciones = OpcionesCodigo());
+void generarEpilogo(Emisor& salida, const OpcionesCodigo& opciones = OpcionesCodigo());
 
 // Mapeo de pseudocódigo a C++
 const map<string, string> MAPEO_FUNCIONES = {
@@ -0,0 +1,279 @@
+#include "incremental.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include "emitter.h"
+#include "generator.h"
+#include "lexer.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "serializer.h"
+#include "types.h"
+
+using namespace std;
+
+namespace {
+
+// Las cadenas no incluyen las comillas en `valor`
+size_t inicioToken(const Token& token, const char* base) {
+    size_t inicio = token.valor.data() - base;
+    return token.tipo == CADENA ? inicio - 1 : inicio;
+}
+
+size_t finToken(const Token& token, const char* base, size_t n) {
+    size_t fin = token.valor.data() + token.valor.size() - base;
+    return (token.tipo == CADENA && fin < n) ? fin + 1 : fin;
+}
+
+// Fin de lo último que leyó el lexer: el parseo hecho hasta ahora no depende
+// de nada posterior
+size_t finSiguiente(FlujoTokens& flujo, const char* base, size_t n) {
+    return flujo.leidoHastaElFinal() ? n : finToken(flujo.ultimoLeido(), base, n);
+}
+
+// Nombres distintos de las variables que la sentencia puede declarar
+// (ASIGNACION, LEER, DECLARACION, DIMENSION) alcanzables desde la raíz: tras optimizar
+// puede haber nodos de ramas eliminadas que ya no se generan
+vector<SimboloId> variablesAsignadas(const ArbolAST& arbol) {
+    vector<SimboloId> nombres;
+    vector<NodoId> pendientes;
+    if (arbol.raiz != NODO_NULO) pendientes.push_back(arbol.raiz);
+    while (!pendientes.empty()) {
+        NodoId id = pendientes.back();
+        pendientes.pop_back();
+        const NodoAST& nodo = arbol[id];
+        SimboloId nombre = SIN_SIMBOLO;
+        // a[i] <- expr y Leer a[i] no declaran nada
+        if ((nodo.tipo == TipoNodo::ASIGNACION && nodo.numHijos < 2) || nodo.tipo == TipoNodo::DECLARACION ||
+            nodo.tipo == TipoNodo::DIMENSION) {
+            nombre = nodo.simbolo;
+        } else if (nodo.tipo == TipoNodo::LEER && nodo.numHijos > 0 &&
+                   arbol[arbol.hijosDe(id)[0]].tipo == TipoNodo::IDENTIFICADOR) {
+            nombre = arbol[arbol.hijosDe(id)[0]].simbolo;
+        }
+        if (nombre != SIN_SIMBOLO && find(nombres.begin(), nombres.end(), nombre) == nombres.end()) {
+            nombres.push_back(nombre);
+        }
+        for (NodoId hijo : arbol.hijosDe(id)) {
+            pendientes.push_back(hijo);
+        }
+    }
+    return nombres;
+}
+
+// Los SubProceso se generan fuera del main y cambian los tipos de todo el
+// programa: con ellos no hay estado incremental. Basta con que aparezca la
+// palabra (aunque sea en un comentario) para compilar entero, que da lo mismo.
+bool mencionaSubprocesos(string_view texto) {
+    for (string_view palabra : {string_view("subproceso"), string_view("funcion")}) {
+        auto igual = [](char a, char b) { return tolower((unsigned char)a) == b; };
+        if (search(texto.begin(), texto.end(), palabra.begin(), palabra.end(), igual) != texto.end()) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+CompilacionIncremental::CompilacionIncremental(const OpcionesCompilacion& opciones)
+    : opciones(opciones), conCabecera(false), finCabecera(0),
+      finSiguienteCabecera(0), analizadas(0), generadas(0) {}
+
+const string& CompilacionIncremental::compilar(string texto) {
+    try {
+        return compilarVersion(move(texto));
+    } catch (...) {
+        // Un error deja el estado a medias: la próxima versión se compila entera
+        fuente.reset();
+        sentencias.clear();
+        conCabecera = false;
+        throw;
+    }
+}
+
+const string& CompilacionIncremental::compilarVersion(string texto) {
+    shared_ptr<const string> anterior = fuente;
+    fuente = make_shared<const string>(move(texto));
+    analizadas = 0;
+    generadas = 0;
+
+    if (!anterior || !conCabecera || mencionaSubprocesos(*fuente) || esASTSerializado(*fuente)) {
+        compilarCompleto();
+        return salida;
+    }
+
+    const string& viejo = *anterior;
+    const string& nuevo = *fuente;
+    if (viejo == nuevo) {
+        return salida;
+    }
+
+    // Zona editada: todo lo que no es prefijo ni sufijo común
+    size_t minimo = min(viejo.size(), nuevo.size());
+    size_t prefijo = 0;
+    while (prefijo < minimo && viejo[prefijo] == nuevo[prefijo]) prefijo++;
+    size_t sufijo = 0;
+    while (sufijo < minimo - prefijo && viejo[viejo.size() - 1 - sufijo] == nuevo[nuevo.size() - 1 - sufijo]) sufijo++;
+
+    // Una sentencia sigue igual si ella y el token que el parser miró después
+    // terminan antes del cambio (el lexer también mira un byte más allá)
+    if (finSiguienteCabecera >= prefijo) {
+        compilarCompleto();
+        return salida;
+    }
+    size_t conservadas = 0;
+    while (conservadas < sentencias.size() && sentencias[conservadas].finSiguiente < prefijo) conservadas++;
+
+    size_t reinicio = conservadas > 0 ? sentencias[conservadas - 1].fin : finCabecera;
+    try {
+        reanalizar(conservadas, reinicio, viejo.size() - sufijo, (ptrdiff_t)nuevo.size() - (ptrdiff_t)viejo.size());
+    } catch (const ErrorSintaxis&) {
+        // Solo se vio el error de una sentencia: el completo los informa todos
+        compilarCompleto();
+        return salida;
+    }
+    generar(conservadas);
+    return salida;
+}
+
+void CompilacionIncremental::compilarCompleto() {
+    string_view texto(*fuente);
+    sentencias.clear();
+    simbolos.limpiar();
+    // Un árbol serializado ya está analizado: solo se genera
+    if (esASTSerializado(texto)) {
+        conCabecera = false;
+        ArbolAST arbol;
+        cargarAST(VistaAST(texto), arbol);
+        salida = generarCodigo(arbol, opciones.codigo);
+        return;
+    }
+
+    Lexer lexer(texto, opciones.ignorarMayusculas, &simbolos);
+    FlujoTokens flujo(lexer);
+
+    string_view nombre;
+    conCabecera = !mencionaSubprocesos(texto) && analizarCabecera(flujo, nombre);
+    if (!conCabecera) {
+        ArbolAST arbol = analizarSintaxis(flujo);
+        if (opciones.optimizar) optimizarArbol(arbol);
+        inferirTipos(arbol);
+        salida = generarCodigo(arbol, opciones.codigo);
+        return;
+    }
+    finCabecera = finToken(flujo.ultimoConsumido(), texto.data(), texto.size());
+    finSiguienteCabecera = finSiguiente(flujo, texto.data(), texto.size());
+
+    try {
+        reanalizar(0, finCabecera, numeric_limits<size_t>::max(), 0);
+    } catch (const ErrorSintaxis&) {
+        // Los errores de todo el programa, como al compilarlo sin estado
+        Lexer completo(texto, opciones.ignorarMayusculas, &simbolos);
+        FlujoTokens todos(completo);
+        analizarSintaxis(todos);
+        throw;
+    }
+    generar(0);
+}
+
+void CompilacionIncremental::reanalizar(size_t conservadas, size_t reinicio, size_t finEditadoViejo, ptrdiff_t delta) {
+    string_view texto(*fuente);
+    const char* base = texto.data();
+    Lexer lexer(texto.substr(reinicio), opciones.ignorarMayusculas, &simbolos);
+    FlujoTokens flujo(lexer);
+
+    vector<Sentencia> nuevas;
+    size_t candidata = conservadas;       // primera sentencia vieja donde podría resincronizar
+    size_t reutilizarDesde = sentencias.size();
+
+    for (;;) {
+        if (!flujo.fin()) {
+            // Si el siguiente token es el inicio de una sentencia vieja posterior
+            // al cambio, el resto del programa se analiza igual que antes
+            ptrdiff_t inicio = (ptrdiff_t)inicioToken(flujo.peek(), base);
+            while (candidata < sentencias.size() &&
+                   (sentencias[candidata].inicio < finEditadoViejo ||
+                    (ptrdiff_t)sentencias[candidata].inicio + delta < inicio)) {
+                candidata++;
+            }
+            if (candidata < sentencias.size() && (ptrdiff_t)sentencias[candidata].inicio + delta == inicio) {
+                reutilizarDesde = candidata;
+                break;
+            }
+        }
+
+        Sentencia sentencia;
+        sentencia.inicio = flujo.fin() ? texto.size() : inicioToken(flujo.peek(), base);
+        if (!analizarSentencia(flujo, sentencia.arbol)) break;
+        if (sentencia.arbol.raiz == NODO_NULO) continue; // "inicio"
+        if (opciones.optimizar) optimizarArbol(sentencia.arbol);
+        sentencia.fuente = fuente;
+        sentencia.fin = finToken(flujo.ultimoConsumido(), base, texto.size());
+        sentencia.finSiguiente = finSiguiente(flujo, base, texto.size());
+        sentencia.pendiente = true;
+        sentencia.asignadas = variablesAsignadas(sentencia.arbol);
+        nuevas.push_back(move(sentencia));
+        analizadas++;
+    }
+
+    vector<Sentencia> resultado;
+    resultado.reserve(conservadas + nuevas.size() + (sentencias.size() - reutilizarDesde));
+    for (size_t i = 0; i < conservadas; i++) {
+        resultado.push_back(move(sentencias[i]));
+    }
+    for (Sentencia& sentencia : nuevas) {
+        resultado.push_back(move(sentencia));
+    }
+    for (size_t i = reutilizarDesde; i < sentencias.size(); i++) {
+        Sentencia& sentencia = sentencias[i];
+        sentencia.inicio += delta;
+        sentencia.fin += delta;
+        sentencia.finSiguiente += delta;
+        resultado.push_back(move(sentencia));
+    }
+    sentencias = move(resultado);
+}
+
+void CompilacionIncremental::generar(size_t conservadas) {
+    // Los tipos son de todo el programa: se vuelven a inferir sobre todas las
+    // sentencias (sin reanalizarlas) y se regenera la que cambie de anotación
+    InferenciaTipos inferencia;
+    for (Sentencia& sentencia : sentencias) {
+        inferencia.agregar(sentencia.arbol, sentencia.arbol.raiz);
+    }
+    inferencia.resolver();
+
+    // Por lo demás, la salida de una sentencia solo depende de cuáles de las
+    // variables que declara estaban ya declaradas: si eso no cambia, se
+    // reutiliza su texto
+    ConjuntoSimbolos declaradas;
+    for (size_t i = 0; i < sentencias.size(); i++) {
+        Sentencia& sentencia = sentencias[i];
+        bool regenerar = inferencia.anotar(sentencia.arbol, sentencia.arbol.raiz) || sentencia.pendiente;
+        for (size_t j = 0; !regenerar && i >= conservadas && j < sentencia.asignadas.size(); j++) {
+            regenerar = declaradas.contiene(sentencia.asignadas[j]) != sentencia.declaradaAntes[j];
+        }
+
+        if (!regenerar) {
+            for (SimboloId nombre : sentencia.asignadas) declaradas.insertar(nombre);
+            continue;
+        }
+
+        sentencia.declaradaAntes.clear();
+        for (SimboloId nombre : sentencia.asignadas) {
+            sentencia.declaradaAntes.push_back(declaradas.contiene(nombre));
+        }
+        Emisor texto;
+        generarSentencia(sentencia.arbol, sentencia.arbol.raiz, declaradas, texto, opciones.codigo);
+        sentencia.salida = texto.tomarTexto();
+        sentencia.pendiente = false;
+        generadas++;
+    }
+
+    Emisor completo;
+    generarPrologo(completo, opciones.codigo);
+    for (const Sentencia& sentencia : sentencias) {
+        completo << sentencia.salida;
+    }
+    generarEpilogo(completo, opciones.codigo);
+    salida = completo.tomarTexto();
+}
@@ -0,0 +1,64 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "compiler.h"
+
+using namespace std;
+
+// Recompilación incremental para los ciclos de edición y compilación: compara
+// la nueva versión del programa con la anterior, vuelve a analizar solo las
+// sentencias del algoritmo afectadas por el cambio (desde la última sentencia
+// intacta hasta que el parser vuelve a coincidir con una sentencia posterior)
+// y regenera solo su parte de la salida. El resultado es idéntico al de
+// compilar el programa completo. Los programas con SubProceso se compilan
+// siempre enteros y un árbol serializado (serializer.h) solo se genera.
+class CompilacionIncremental {
+public:
+    // Usa ignorarMayusculas, optimizar y codigo (sin caché ni estadísticas)
+    explicit CompilacionIncremental(const OpcionesCompilacion& opciones = OpcionesCompilacion());
+
+    // Devuelve el C++ de `texto`. Lanza runtime_error como Compilador::compilar.
+    const string& compilar(string texto);
+
+    // Estadísticas de la última llamada a compilar()
+    size_t sentenciasAnalizadas() const { return analizadas; }
+    size_t sentenciasGeneradas() const { return generadas; }
+    size_t totalSentencias() const { return sentencias.size(); }
+
+private:
+    struct Sentencia {
+        shared_ptr<const string> fuente; // versión del texto a la que apunta `arbol`
+        ArbolAST arbol;
+        size_t inicio;    // posiciones en el texto actual
+        size_t fin;
+        size_t finSiguiente; // fin del token siguiente (del que depende el parseo)
+        vector<SimboloId> asignadas;
+        vector<bool> declaradaAntes;
+        string salida;
+        bool pendiente;
+    };
+
+    const string& compilarVersion(string texto);
+    void compilarCompleto();
+    void reanalizar(size_t conservadas, size_t reinicio, size_t finEditadoViejo, ptrdiff_t delta);
+    void generar(size_t conservadas);
+
+    OpcionesCompilacion opciones;
+    shared_ptr<const string> fuente;
+    bool conCabecera; // sin "Algoritmo" inicial no hay estado incremental
+    size_t finCabecera;
+    size_t finSiguienteCabecera;
+    // Compartida por los árboles de todas las sentencias; se vacía al compilar
+    // una versión entera
+    TablaSimbolos simbolos;
+    vector<Sentencia> sentencias;
+    string salida;
+    size_t analizadas;
+    size_t generadas;
+};
+
+#endif
@@ -0,0 +1,732 @@
+#include "interpreter.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+#include "types.h"
+
+using namespace std;
+
+LimitePasosAlcanzado::LimitePasosAlcanzado(uint64_t pasos)
+    : ErrorEjecucion("el programa sigue tras " + to_string(pasos) +
+                     " pasos; para los que tardan, genera el C++ y compílalo (sin --ejecutar)") {}
+
+namespace {
+
+// Pila que pueden usar las llamadas del programa: cada una es recursión en el
+// intérprete, y una recursión sin fin tiene que acabar en un error y no
+// desbordando la pila del hilo (8 MB normalmente; lo que queda basta para los
+// MAX_ANIDAMIENTO bloques y expresiones de la última)
+const size_t MAX_PILA_LLAMADAS = 4 << 20;
+
+const uint32_t SIN_RANURA = UINT32_MAX;
+const size_t SIN_INDICE = SIZE_MAX;
+
+struct Valor {
+    TipoDato tipo = TipoDato::ENTERO;
+    long long entero = 0; // LOGICO, ENTERO y ENTERO_LARGO
+    double real = 0;
+    string texto;
+};
+
+struct Variable {
+    bool definida = false; // ya declarada en el C++ generado
+    bool arreglo = false;  // con Dimension: los valores están en `elementos`
+    Valor valor;
+    vector<Valor> elementos;
+};
+
+// Lo que es un nombre en una llamada: su propia variable, la del llamador
+// (arreglos y Por Referencia) o un elemento de un arreglo del llamador
+struct Ranura {
+    Variable propia;
+    Variable* enlace = nullptr;
+    size_t indice = SIN_INDICE; // con enlace: el elemento enlazado
+};
+
+// int si no se sabe nada, como tipoCpp
+TipoDato tipoVariable(TipoDato tipo) {
+    return tipo == TipoDato::DESCONOCIDO ? TipoDato::ENTERO : tipo;
+}
+
+Valor valorInicial(TipoDato tipo) {
+    Valor valor;
+    valor.tipo = tipoVariable(tipo);
+    return valor;
+}
+
+double comoReal(const Valor& valor) {
+    return valor.tipo == TipoDato::REAL ? valor.real : (double)valor.entero;
+}
+
+// De long long a int se quedan los 32 bits bajos, como en g++
+long long aInt(long long valor) {
+    return (int32_t)(uint32_t)(unsigned long long)valor;
+}
+
+// Lo que hace C++ al guardar `valor` en una variable de tipo `tipo`
+Valor convertir(Valor valor, TipoDato tipo, string_view nombre) {
+    tipo = tipoVariable(tipo);
+    if (valor.tipo == tipo) return valor;
+    if (tipo == TipoDato::CADENA || valor.tipo == TipoDato::CADENA) {
+        throw ErrorEjecucion(string(valor.tipo == TipoDato::CADENA ? "una cadena" : "un número") +
+                             " no se puede guardar en " + string(nombre) + " (" + string(tipoCpp(tipo)) + ")");
+    }
+    Valor resultado;
+    resultado.tipo = tipo;
+    if (tipo == TipoDato::REAL) {
+        resultado.real = comoReal(valor);
+    } else if (tipo == TipoDato::LOGICO) {
+        resultado.entero = valor.tipo == TipoDato::REAL ? valor.real != 0 : valor.entero != 0;
+    } else if (valor.tipo == TipoDato::REAL) {
+        // Trunca; fuera del rango del tipo C++ no lo define
+        double truncado = trunc(valor.real);
+        double limite = tipo == TipoDato::ENTERO ? 2147483648.0 : 9223372036854775808.0;
+        if (!(truncado >= -limite && truncado < limite)) {
+            throw ErrorEjecucion("el valor no cabe en " + string(nombre) + " (" + string(tipoCpp(tipo)) + ")");
+        }
+        resultado.entero = (long long)truncado;
+    } else {
+        resultado.entero = tipo == TipoDato::ENTERO ? aInt(valor.entero) : valor.entero;
+    }
+    return resultado;
+}
+
+template <typename T>
+bool comparar(Operador op, const T& a, const T& b) {
+    switch (op) {
+    case Operador::MENOR: return a < b;
+    case Operador::MAYOR: return a > b;
+    case Operador::MENOR_IGUAL: return a <= b;
+    case Operador::MAYOR_IGUAL: return a >= b;
+    case Operador::IGUAL_IGUAL: return a == b;
+    default: return a != b;
+    }
+}
+
+string textoOperador(Operador op) {
+    return string(OPERADORES[(size_t)op].texto);
+}
+
+// Operación binaria con las conversiones de C++: el resultado es del mayor de
+// los tipos, y como poco int (bool + bool ya es int)
+Valor operar(Operador op, const Valor& a, const Valor& b) {
+    Valor resultado;
+    if (op >= Operador::MENOR && op <= Operador::DISTINTO) {
+        resultado.tipo = TipoDato::LOGICO;
+        if (a.tipo == TipoDato::CADENA || b.tipo == TipoDato::CADENA) {
+            if (a.tipo != b.tipo) throw ErrorEjecucion("no se puede comparar una cadena con un número");
+            resultado.entero = comparar(op, a.texto, b.texto);
+        } else if (a.tipo == TipoDato::REAL || b.tipo == TipoDato::REAL) {
+            resultado.entero = comparar(op, comoReal(a), comoReal(b));
+        } else {
+            resultado.entero = comparar(op, a.entero, b.entero);
+        }
+        return resultado;
+    }
+    if (op < Operador::SUMA || op > Operador::DIVISION) {
+        throw ErrorEjecucion("el operador '" + textoOperador(op) + "' no se puede usar en una expresión");
+    }
+    if (a.tipo == TipoDato::CADENA || b.tipo == TipoDato::CADENA) {
+        if (a.tipo != b.tipo) {
+            throw ErrorEjecucion("el operador '" + textoOperador(op) + "' no se puede usar con una cadena y un número");
+        }
+        if (op != Operador::SUMA) {
+            throw ErrorEjecucion("el operador '" + textoOperador(op) + "' no se puede usar con cadenas (solo '+')");
+        }
+        resultado.tipo = TipoDato::CADENA;
+        resultado.texto.reserve(a.texto.size() + b.texto.size());
+        resultado.texto.append(a.texto).append(b.texto);
+        return resultado;
+    }
+
+    resultado.tipo = max(TipoDato::ENTERO, max(a.tipo, b.tipo));
+    if (resultado.tipo == TipoDato::REAL) {
+        double x = comoReal(a), y = comoReal(b);
+        switch (op) {
+        case Operador::SUMA: resultado.real = x + y; break;
+        case Operador::RESTA: resultado.real = x - y; break;
+        case Operador::MULTIPLICACION: resultado.real = x * y; break;
+        default: resultado.real = x / y; break;
+        }
+        return resultado;
+    }
+    // El desbordamiento da la vuelta (sin signo no está indefinido)
+    unsigned long long x = (unsigned long long)a.entero, y = (unsigned long long)b.entero;
+    switch (op) {
+    case Operador::SUMA: resultado.entero = (long long)(x + y); break;
+    case Operador::RESTA: resultado.entero = (long long)(x - y); break;
+    case Operador::MULTIPLICACION: resultado.entero = (long long)(x * y); break;
+    default:
+        if (b.entero == 0) throw ErrorEjecucion("división entera por cero");
+        resultado.entero = b.entero == -1 ? (long long)(0ull - x) : a.entero / b.entero;
+        break;
+    }
+    if (resultado.tipo == TipoDato::ENTERO) resultado.entero = aInt(resultado.entero);
+    return resultado;
+}
+
+// El texto de una CADENA como lo ve C++: el generador la escribe entre
+// comillas tal cual, con sus secuencias de escape
+string textoCadena(string_view texto) {
+    string resultado;
+    resultado.reserve(texto.size());
+    for (size_t i = 0; i < texto.size(); i++) {
+        char c = texto[i];
+        if (c == '\\' && i + 1 < texto.size()) {
+            c = texto[++i];
+            if (c == 'n') c = '\n';
+            else if (c == 't') c = '\t';
+            else if (c == 'r') c = '\r';
+            else if (c == '0') c = '\0';
+        }
+        resultado += c;
+    }
+    return resultado;
+}
+
+class Interprete {
+public:
+    Interprete(const ArbolAST& arbol, istream& entrada, ostream& salida, const OpcionesEjecucion& opciones)
+        : arbol(arbol), entrada(entrada), salida(salida),
+          limite(opciones.limitePasos ? opciones.limitePasos : UINT64_MAX) {}
+
+    void ejecutar() {
+        if (arbol.raiz == NODO_NULO) return;
+        preparar();
+        NodoId algoritmo = NODO_NULO;
+        for (NodoId unidad : unidades) {
+            if (arbol[unidad].tipo == TipoNodo::ALGORITMO) algoritmo = unidad;
+        }
+        if (algoritmo == NODO_NULO) throw ErrorEjecucion("el programa no tiene un Algoritmo que ejecutar");
+        char base;
+        basePila = (uintptr_t)&base;
+        actual = &abrirMarco(tamanoMarco[algoritmo]);
+        ejecutarSentencias(algoritmo);
+    }
+
+private:
+    const ArbolAST& arbol;
+    istream& entrada;
+    ostream& salida;
+    uint64_t limite;
+    uint64_t pasos = 0;
+    uintptr_t basePila = 0;
+
+    vector<NodoId> unidades;    // el algoritmo y los SubProceso
+    vector<NodoId> funcionDe;   // por id del nombre: su FUNCION
+    // Por nodo: la ranura de su variable en el marco de su unidad; en NUMERO,
+    // CADENA y Verdadero/Falso, su valor en `constantes`
+    vector<uint32_t> ranuraDe;
+    vector<uint32_t> tamanoMarco; // por nodo de unidad: sus ranuras
+    vector<bool> declara;         // DECLARACION que en el C++ es la declaración (= 0)
+    vector<Valor> constantes;
+
+    // Un marco por llamada en curso; se reutilizan de una llamada a otra
+    deque<vector<Ranura>> marcos;
+    size_t abiertos = 0;
+    vector<Ranura>* actual = nullptr;
+
+    // Numera las variables de cada unidad, convierte una sola vez los
+    // literales y marca qué Definir declaran, recorriendo como el generador
+    void preparar() {
+        size_t n = arbol.nodos.size();
+        ranuraDe.assign(n, SIN_RANURA);
+        tamanoMarco.assign(n, 0);
+        declara.assign(n, false);
+        if (arbol[arbol.raiz].tipo == TipoNodo::PROGRAMA) {
+            RangoHijos hijos = arbol.hijosDe(arbol.raiz);
+            unidades.assign(hijos.begin(), hijos.end());
+        } else {
+            unidades.assign(1, arbol.raiz);
+        }
+
+        for (NodoId unidad : unidades) {
+            const NodoAST& nodo = arbol[unidad];
+            if (nodo.tipo != TipoNodo::FUNCION || nodo.simbolo == SIN_SIMBOLO) continue;
+            if (nodo.simbolo >= funcionDe.size()) funcionDe.resize(nodo.simbolo + 1, NODO_NULO);
+            if (funcionDe[nodo.simbolo] == NODO_NULO) funcionDe[nodo.simbolo] = unidad;
+        }
+
+        vector<uint32_t> ranuraDeSimbolo;
+        vector<bool> declarada;
+        vector<SimboloId> usados;
+        vector<NodoId> pendientes;
+        for (NodoId unidad : unidades) {
+            uint32_t ranuras = 0;
+            auto numerar = [&](NodoId id) {
+                SimboloId simbolo = arbol[id].simbolo;
+                if (simbolo == SIN_SIMBOLO) throw ErrorEjecucion("el árbol no tiene tabla de símbolos");
+                if (simbolo >= ranuraDeSimbolo.size()) {
+                    ranuraDeSimbolo.resize(simbolo + 1, SIN_RANURA);
+                    declarada.resize(simbolo + 1, false);
+                }
+                if (ranuraDeSimbolo[simbolo] == SIN_RANURA) {
+                    ranuraDeSimbolo[simbolo] = ranuras++;
+                    usados.push_back(simbolo);
+                }
+                ranuraDe[id] = ranuraDeSimbolo[simbolo];
+            };
+            // Como CodeGenerator::declarar: true la primera vez
+            auto declarar = [&](NodoId id) {
+                numerar(id);
+                SimboloId simbolo = arbol[id].simbolo;
+                bool primera = !declarada[simbolo];
+                declarada[simbolo] = true;
+                return primera;
+            };
+
+            pendientes.clear();
+            if (arbol[unidad].tipo == TipoNodo::FUNCION) {
+                // Los parámetros y la variable de retorno se declaran al empezar
+                RangoHijos partes = arbol.hijosDe(unidad);
+                if (partes.size() < 2) continue;
+                for (NodoId parametro : arbol.hijosDe(partes[0])) declarar(parametro);
+                if (partes.size() > 2) declarar(partes[2]);
+                pendientes.push_back(partes[1]);
+            } else {
+                pendientes.push_back(unidad);
+            }
+            while (!pendientes.empty()) {
+                NodoId id = pendientes.back();
+                pendientes.pop_back();
+                const NodoAST& nodo = arbol[id];
+                RangoHijos hijos = arbol.hijosDe(id);
+                switch (nodo.tipo) {
+                case TipoNodo::IDENTIFICADOR:
+                case TipoNodo::ELEMENTO:
+                case TipoNodo::PARA:
+                    numerar(id);
+                    break;
+                case TipoNodo::ASIGNACION:
+                    if (hijos.size() > 1) {
+                        numerar(id);
+                    } else {
+                        declarar(id);
+                    }
+                    break;
+                case TipoNodo::LEER:
+                    if (!hijos.empty() && arbol[hijos[0]].tipo == TipoNodo::IDENTIFICADOR) declarar(hijos[0]);
+                    break;
+                case TipoNodo::DECLARACION:
+                    declara[id] = declarar(id) && !nodo.arreglo;
+                    break;
+                case TipoNodo::DIMENSION:
+                    declarar(id);
+                    break;
+                case TipoNodo::NUMERO:
+                    ranuraDe[id] = constante(numero(nodo.valor));
+                    break;
+                case TipoNodo::CADENA: {
+                    Valor valor;
+                    valor.tipo = TipoDato::CADENA;
+                    valor.texto = textoCadena(nodo.valor);
+                    ranuraDe[id] = constante(move(valor));
+                    break;
+                }
+                case TipoNodo::EXPRESION: {
+                    Valor valor;
+                    valor.tipo = TipoDato::LOGICO;
+                    valor.entero = !nodo.valor.empty() && tolower((unsigned char)nodo.valor[0]) == 'v';
+                    ranuraDe[id] = constante(move(valor));
+                    break;
+                }
+                default:
+                    break;
+                }
+                for (size_t i = hijos.size(); i-- > 0;) {
+                    if (hijos[i] != NODO_NULO) pendientes.push_back(hijos[i]);
+                }
+            }
+            tamanoMarco[unidad] = ranuras;
+            for (SimboloId simbolo : usados) {
+                ranuraDeSimbolo[simbolo] = SIN_RANURA;
+                declarada[simbolo] = false;
+            }
+            usados.clear();
+        }
+    }
+
+    uint32_t constante(Valor valor) {
+        constantes.push_back(move(valor));
+        return (uint32_t)(constantes.size() - 1);
+    }
+
+    static Valor numero(string_view texto) {
+        Valor valor;
+        valor.tipo = tipoLiteral(texto);
+        if (valor.tipo == TipoDato::REAL) {
+            valor.real = strtod(string(texto).c_str(), nullptr);
+            return valor;
+        }
+        const char* fin = texto.data() + texto.size();
+        auto [ptr, ec] = from_chars(texto.data(), fin, valor.entero);
+        if (ec != errc() || ptr != fin) throw ErrorEjecucion("el número " + string(texto) + " no cabe en un long long");
+        return valor;
+    }
+
+    string nombre(NodoId id) const {
+        return string(arbol[id].valor);
+    }
+
+    void paso() {
+        if (++pasos > limite) throw LimitePasosAlcanzado(limite);
+    }
+
+    vector<Ranura>& abrirMarco(uint32_t ranuras) {
+        if (abiertos == marcos.size()) marcos.emplace_back();
+        vector<Ranura>& marco = marcos[abiertos++];
+        marco.clear();
+        marco.resize(ranuras);
+        return marco;
+    }
+
+    Ranura& ranura(NodoId id) {
+        return (*actual)[ranuraDe[id]];
+    }
+
+    // La variable con Dimension que nombra el nodo
+    Variable& arregloDe(NodoId id) {
+        Ranura& r = ranura(id);
+        if (r.indice != SIN_INDICE) throw ErrorEjecucion(nombre(id) + " no es un arreglo");
+        return r.enlace ? *r.enlace : r.propia;
+    }
+
+    // Con el índice comprobado, que el C++ generado no comprueba
+    Valor& elemento(Variable& arreglo, long long indice, NodoId id) {
+        if (!arreglo.arreglo) throw ErrorEjecucion(nombre(id) + " no es un arreglo (falta su Dimension)");
+        if (indice < 0 || (unsigned long long)indice >= arreglo.elementos.size()) {
+            throw ErrorEjecucion("el índice " + to_string(indice) + " está fuera del arreglo " + nombre(id) +
+                                 " (de 0 a " + to_string(arreglo.elementos.size() - 1) + ")");
+        }
+        return arreglo.elementos[indice];
+    }
+
+    long long indice(NodoId id) {
+        Valor valor = evaluar(id);
+        if (valor.tipo == TipoDato::CADENA) throw ErrorEjecucion("el índice de un arreglo no puede ser una cadena");
+        return convertir(move(valor), TipoDato::ENTERO_LARGO, "un índice").entero;
+    }
+
+    const Valor& leer(NodoId id) {
+        Ranura& r = ranura(id);
+        if (r.indice != SIN_INDICE) return elemento(*r.enlace, r.indice, id);
+        Variable& variable = r.enlace ? *r.enlace : r.propia;
+        if (variable.arreglo) throw ErrorEjecucion(nombre(id) + " es un arreglo: falta el índice");
+        if (!variable.definida) throw ErrorEjecucion("la variable " + nombre(id) + " se usa sin tener un valor");
+        return variable.valor;
+    }
+
+    void guardar(NodoId id, Valor valor, TipoDato tipo) {
+        Ranura& r = ranura(id);
+        if (r.indice != SIN_INDICE) {
+            Valor& destino = elemento(*r.enlace, r.indice, id);
+            destino = convertir(move(valor), destino.tipo, arbol[id].valor);
+            return;
+        }
+        Variable& variable = r.enlace ? *r.enlace : r.propia;
+        if (variable.arreglo) throw ErrorEjecucion(nombre(id) + " es un arreglo: falta el índice");
+        variable.valor = convertir(move(valor), tipo, arbol[id].valor);
+        variable.definida = true;
+    }
+
+    Valor evaluar(NodoId id) {
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        switch (nodo.tipo) {
+        case TipoNodo::NUMERO:
+        case TipoNodo::CADENA:
+        case TipoNodo::EXPRESION:
+            return constantes[ranuraDe[id]];
+        case TipoNodo::IDENTIFICADOR:
+            return leer(id);
+        case TipoNodo::ELEMENTO: {
+            if (hijos.empty()) throw ErrorEjecucion("falta el índice de " + nombre(id));
+            long long i = indice(hijos[0]);
+            return elemento(arregloDe(id), i, id);
+        }
+        case TipoNodo::OPERACION_BINARIA: {
+            if (hijos.size() < 2) throw ErrorEjecucion("falta un operando de '" + textoOperador(nodo.operador) + "'");
+            Valor a = evaluar(hijos[0]);
+            Valor b = evaluar(hijos[1]);
+            return operar(nodo.operador, a, b);
+        }
+        case TipoNodo::LLAMADA:
+            return llamar(id, true);
+        default:
+            throw ErrorEjecucion("expresión no válida");
+        }
+    }
+
+    bool condicion(NodoId id) {
+        Valor valor = evaluar(id);
+        if (valor.tipo == TipoDato::CADENA) throw ErrorEjecucion("una condición no puede ser una cadena");
+        return valor.tipo == TipoDato::REAL ? valor.real != 0 : valor.entero != 0;
+    }
+
+    void escribir(const Valor& valor) {
+        switch (valor.tipo) {
+        case TipoDato::LOGICO: salida << (valor.entero != 0); break;
+        case TipoDato::ENTERO: salida << (int)valor.entero; break;
+        case TipoDato::REAL: salida << valor.real; break;
+        case TipoDato::CADENA: salida << valor.texto; break;
+        default: salida << valor.entero; break;
+        }
+    }
+
+    // >> del tipo de la variable: si falla deja 0, y al final de la entrada no la toca
+    void leerValor(Valor& valor) {
+        switch (valor.tipo) {
+        case TipoDato::LOGICO: {
+            bool b = valor.entero != 0;
+            entrada >> b;
+            valor.entero = b;
+            break;
+        }
+        case TipoDato::ENTERO: {
+            int x = (int)valor.entero;
+            entrada >> x;
+            valor.entero = x;
+            break;
+        }
+        case TipoDato::REAL: entrada >> valor.real; break;
+        case TipoDato::CADENA: entrada >> valor.texto; break;
+        default: entrada >> valor.entero; break;
+        }
+    }
+
+    void ejecutarLeer(const NodoAST& nodo, NodoId destino) {
+        RangoHijos hijos = arbol.hijosDe(destino);
+        if (arbol[destino].tipo == TipoNodo::ELEMENTO) {
+            if (hijos.empty()) throw ErrorEjecucion("falta el índice de " + nombre(destino));
+            long long i = indice(hijos[0]);
+            leerValor(elemento(arregloDe(destino), i, destino));
+            return;
+        }
+        if (arbol[destino].tipo != TipoNodo::IDENTIFICADOR) throw ErrorEjecucion("Leer necesita una variable");
+        Ranura& r = ranura(destino);
+        if (r.indice != SIN_INDICE) {
+            leerValor(elemento(*r.enlace, r.indice, destino));
+            return;
+        }
+        Variable& variable = r.enlace ? *r.enlace : r.propia;
+        if (variable.arreglo) throw ErrorEjecucion(nombre(destino) + " es un arreglo: falta el índice");
+        TipoDato tipo = tipoVariable(nodo.tipoDato);
+        if (!variable.definida || variable.valor.tipo != tipo) variable.valor = valorInicial(tipo);
+        variable.definida = true;
+        leerValor(variable.valor);
+    }
+
+    // for (T i = inicio; i <= fin; i++): el contador es una variable nueva que
+    // tapa a la del mismo nombre hasta que termina el bucle
+    void ejecutarPara(NodoId id) {
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        if (hijos.size() < 2) return;
+        TipoDato tipo = tipoVariable(nodo.tipoDato);
+        if (tipo == TipoDato::CADENA || tipo == TipoDato::LOGICO) {
+            throw ErrorEjecucion("el contador " + nombre(id) + " de un Para tiene que ser un número");
+        }
+        Valor inicio = convertir(evaluar(hijos[0]), tipo, nodo.valor);
+        Ranura& r = ranura(id);
+        Ranura tapada = move(r);
+        r = Ranura();
+        Variable& contador = r.propia;
+        contador.valor = move(inicio);
+        contador.definida = true;
+        for (;;) {
+            paso();
+            Valor fin = evaluar(hijos[1]);
+            if (contador.arreglo) throw ErrorEjecucion(nombre(id) + " es un arreglo: falta el índice");
+            if (!operar(Operador::MENOR_IGUAL, contador.valor, fin).entero) break;
+            if (hijos.size() > 2) ejecutarBloque(hijos[2]);
+            Valor& valor = contador.valor;
+            if (valor.tipo == TipoDato::REAL) {
+                valor.real += 1;
+            } else {
+                valor.entero = (long long)((unsigned long long)valor.entero + 1);
+                if (valor.tipo == TipoDato::ENTERO) valor.entero = aInt(valor.entero);
+            }
+        }
+        r = move(tapada);
+    }
+
+    // Arreglos y Por Referencia: el parámetro es la variable (o el elemento) del llamador
+    void enlazar(Ranura& r, NodoId argumento, const NodoAST& parametro) {
+        const NodoAST& nodo = arbol[argumento];
+        if (nodo.tipo == TipoNodo::ELEMENTO && !parametro.arreglo && nodo.numHijos > 0) {
+            long long i = indice(arbol.hijosDe(argumento)[0]);
+            Variable& arreglo = arregloDe(argumento);
+            elemento(arreglo, i, argumento);
+            r.enlace = &arreglo;
+            r.indice = (size_t)i;
+            return;
+        }
+        if (nodo.tipo != TipoNodo::IDENTIFICADOR) {
+            throw ErrorEjecucion("el parámetro " + string(parametro.valor) + " necesita una variable, no una expresión");
+        }
+        Ranura& origen = ranura(argumento);
+        if (origen.indice != SIN_INDICE) {
+            if (parametro.arreglo) throw ErrorEjecucion(nombre(argumento) + " no es un arreglo");
+            r.enlace = origen.enlace;
+            r.indice = origen.indice;
+            return;
+        }
+        Variable& variable = origen.enlace ? *origen.enlace : origen.propia;
+        if (parametro.arreglo && !variable.arreglo) throw ErrorEjecucion(nombre(argumento) + " no es un arreglo");
+        r.enlace = &variable;
+    }
+
+    // Los argumentos se evalúan en el marco del llamador; las llamadas que
+    // hagan abren los suyos por encima del de esta
+    Valor llamar(NodoId id, bool usaValor) {
+        const NodoAST& nodo = arbol[id];
+        NodoId funcion = nodo.simbolo < funcionDe.size() ? funcionDe[nodo.simbolo] : NODO_NULO;
+        if (funcion == NODO_NULO) throw ErrorEjecucion("no hay ningún SubProceso " + nombre(id));
+        RangoHijos partes = arbol.hijosDe(funcion);
+        if (partes.size() < 2) throw ErrorEjecucion("al SubProceso " + nombre(id) + " le falta el cuerpo");
+        NodoId retorno = partes.size() > 2 ? partes[2] : NODO_NULO;
+        if (usaValor && retorno == NODO_NULO) throw ErrorEjecucion(nombre(id) + " no devuelve ningún valor");
+        char cima;
+        uintptr_t usada = basePila > (uintptr_t)&cima ? basePila - (uintptr_t)&cima : (uintptr_t)&cima - basePila;
+        if (usada > MAX_PILA_LLAMADAS) {
+            throw ErrorEjecucion("demasiadas llamadas anidadas (" + to_string(abiertos - 1) + ") al llamar a " +
+                                 nombre(id) + ": ¿una recursión sin fin?");
+        }
+        RangoHijos parametros = arbol.hijosDe(partes[0]);
+        RangoHijos argumentos = arbol.hijosDe(id);
+        if (parametros.size() != argumentos.size()) {
+            throw ErrorEjecucion(nombre(id) + " recibe " + to_string(parametros.size()) + " argumentos y se le pasan " +
+                                 to_string(argumentos.size()));
+        }
+
+        vector<Ranura>& marco = abrirMarco(tamanoMarco[funcion]);
+        for (size_t i = 0; i < parametros.size(); i++) {
+            const NodoAST& parametro = arbol[parametros[i]];
+            Ranura& r = marco[ranuraDe[parametros[i]]];
+            if (parametro.arreglo || parametro.numHijos > 0) {
+                enlazar(r, argumentos[i], parametro);
+            } else {
+                r.propia.valor = convertir(evaluar(argumentos[i]), parametro.tipoDato, parametro.valor);
+                r.propia.definida = true;
+            }
+        }
+        if (retorno != NODO_NULO) {
+            Ranura& r = marco[ranuraDe[retorno]];
+            if (!r.enlace && !r.propia.definida) {
+                r.propia.valor = valorInicial(arbol[funcion].tipoDato);
+                r.propia.definida = true;
+            }
+        }
+
+        vector<Ranura>* llamador = actual;
+        actual = &marco;
+        ejecutarBloque(partes[1]);
+        Valor resultado;
+        if (retorno != NODO_NULO) resultado = convertir(leer(retorno), arbol[funcion].tipoDato, arbol[retorno].valor);
+        actual = llamador;
+        abiertos--;
+        return resultado;
+    }
+
+    void ejecutarAsignacion(NodoId id) {
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        if (hijos.empty()) return;
+        // C++17: en a[i] = e se evalúa primero e
+        Valor valor = evaluar(hijos[0]);
+        if (hijos.size() > 1) {
+            long long i = indice(hijos[1]);
+            Valor& destino = elemento(arregloDe(id), i, id);
+            destino = convertir(move(valor), destino.tipo, nodo.valor);
+        } else {
+            guardar(id, move(valor), nodo.tipoDato);
+        }
+    }
+
+    // Tamaño n + 1 como en el generador: índices de 0 a n
+    void ejecutarDimension(NodoId id) {
+        RangoHijos hijos = arbol.hijosDe(id);
+        long long tamano = hijos.empty() ? 0 : indice(hijos[0]);
+        if (tamano < 0) throw ErrorEjecucion("la Dimension de " + nombre(id) + " es negativa");
+        Variable& arreglo = arregloDe(id);
+        arreglo.arreglo = true;
+        arreglo.definida = true;
+        arreglo.elementos.assign((size_t)tamano + 1, valorInicial(arbol[id].tipoDato));
+    }
+
+    void ejecutarSentencias(NodoId id) {
+        for (NodoId sentencia : arbol.hijosDe(id)) {
+            if (sentencia == NODO_NULO) continue;
+            paso();
+            ejecutarSentencia(sentencia);
+        }
+    }
+
+    void ejecutarBloque(NodoId id) {
+        if (id == NODO_NULO) return;
+        if (arbol[id].tipo == TipoNodo::BLOQUE) {
+            ejecutarSentencias(id);
+        } else {
+            paso();
+            ejecutarSentencia(id);
+        }
+    }
+
+    void ejecutarSentencia(NodoId id) {
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        switch (nodo.tipo) {
+        case TipoNodo::ESCRIBIR:
+            if (!hijos.empty()) escribir(evaluar(hijos[0]));
+            salida << '\n';
+            break;
+        case TipoNodo::LEER:
+            if (!hijos.empty()) ejecutarLeer(nodo, hijos[0]);
+            break;
+        case TipoNodo::SI:
+            if (hijos.empty()) break;
+            if (condicion(hijos[0])) {
+                if (hijos.size() > 1) ejecutarBloque(hijos[1]);
+            } else if (hijos.size() > 2) {
+                ejecutarBloque(hijos[2]);
+            }
+            break;
+        case TipoNodo::PARA:
+            ejecutarPara(id);
+            break;
+        case TipoNodo::MIENTRAS:
+            while (!hijos.empty() && condicion(hijos[0])) {
+                paso();
+                if (hijos.size() > 1) ejecutarBloque(hijos[1]);
+            }
+            break;
+        case TipoNodo::ASIGNACION:
+            ejecutarAsignacion(id);
+            break;
+        case TipoNodo::BLOQUE:
+            ejecutarSentencias(id);
+            break;
+        case TipoNodo::DECLARACION:
+            if (declara[id]) guardar(id, valorInicial(nodo.tipoDato), nodo.tipoDato);
+            break;
+        case TipoNodo::DIMENSION:
+            ejecutarDimension(id);
+            break;
+        case TipoNodo::LLAMADA:
+            llamar(id, false);
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+} // namespace
+
+void ejecutarArbol(const ArbolAST& arbol, istream& entrada, ostream& salida, const OpcionesEjecucion& opciones) {
+    Interprete(arbol, entrada, salida, opciones).ejecutar();
+}
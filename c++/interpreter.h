@@ -0,0 +1,43 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include "ast.h"
+
+using namespace std;
+
+// Intérprete del árbol (--ejecutar): corre el programa al momento, sin generar
+// C++ ni pasar por g++. Necesita los tipos de inferirTipos y hace lo mismo que
+// el C++ generado: cada variable guarda el tipo de C++ con que se declararía
+// (int, long long, double, string o bool), la aritmética de int es de 32 bits,
+// la división entre enteros trunca y Escribir y Leer son << y >> sobre los
+// flujos. Lo que en C++ no compilaría o no estaría definido (usar una variable
+// sin valor, salirse de un arreglo, dividir un entero por cero...) lanza
+// ErrorEjecucion; lo ya escrito en la salida se queda.
+class ErrorEjecucion : public runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
+// El programa llegó a OpcionesEjecucion::limitePasos: es de los que conviene
+// compilar a C++.
+class LimitePasosAlcanzado : public ErrorEjecucion {
+public:
+    explicit LimitePasosAlcanzado(uint64_t pasos);
+};
+
+struct OpcionesEjecucion {
+    // Sentencias ejecutadas (cada vuelta de un bucle cuenta como una) antes de
+    // abandonar con LimitePasosAlcanzado; 0 = sin límite
+    uint64_t limitePasos = 0;
+};
+
+// Ejecuta el algoritmo de `arbol` (ya con tipos) leyendo de `entrada` y
+// escribiendo en `salida`.
+void ejecutarArbol(const ArbolAST& arbol, istream& entrada, ostream& salida,
+                   const OpcionesEjecucion& opciones = OpcionesEjecucion());
+
+#endif
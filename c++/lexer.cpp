@@ -1,83 +1,433 @@
 #include "lexer.h"
-#include <cctype>
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "scanner.h"
+#include "thread_pool.h"
 
 using namespace std;
 
-vector<Token> analizarLexico(const string& codigo) {
-    vector<Token> tokens;
-    int linea = 1;
-    size_t i = 0;
+namespace {
+
+constexpr size_t NUM_PALABRAS = sizeof(PALABRAS_RESERVADAS) / sizeof(PALABRAS_RESERVADAS[0]);
+static_assert(NUM_PALABRAS == (size_t)PalabraClave::FALSO, "PalabraClave y PALABRAS_RESERVADAS no coinciden");
+
+constexpr int BITS_TABLA = 7;
+constexpr uint32_t TAM_TABLA = 1u << BITS_TABLA;
+
+constexpr uint32_t minuscula(char c) {
+    return (c >= 'A' && c <= 'Z') ? (uint32_t)(c - 'A' + 'a') : (uint32_t)(unsigned char)c;
+}
+
+// Usa primera, central y última letra (sin distinguir mayúsculas) y la longitud,
+// así la misma tabla sirve para las dos variantes de búsqueda.
+constexpr uint32_t hashPalabra(string_view s, uint32_t semilla) {
+    uint32_t h = semilla;
+    h = (h ^ minuscula(s[0])) * 16777619u;
+    h = (h ^ minuscula(s[s.size() / 2])) * 16777619u;
+    h = (h ^ minuscula(s[s.size() - 1])) * 16777619u;
+    h = (h ^ (uint32_t)s.size()) * 16777619u;
+    return h >> (32 - BITS_TABLA);
+}
+
+constexpr bool semillaSinColisiones(uint32_t semilla) {
+    bool ocupado[TAM_TABLA] = {};
+    for (size_t i = 0; i < NUM_PALABRAS; i++) {
+        uint32_t h = hashPalabra(PALABRAS_RESERVADAS[i], semilla);
+        if (ocupado[h]) return false;
+        ocupado[h] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t buscarSemilla() {
+    for (uint32_t semilla = 2166136261u; semilla < 2166136261u + 10000; semilla++) {
+        if (semillaSinColisiones(semilla)) return semilla;
+    }
+    return 0;
+}
+
+constexpr uint32_t SEMILLA = buscarSemilla();
+static_assert(SEMILLA != 0, "No se encontró un hash perfecto para PALABRAS_RESERVADAS");
+
+struct TablaPalabras {
+    PalabraClave entradas[TAM_TABLA];
+};
+
+constexpr TablaPalabras construirTabla() {
+    TablaPalabras tabla{};
+    for (size_t i = 0; i < NUM_PALABRAS; i++) {
+        tabla.entradas[hashPalabra(PALABRAS_RESERVADAS[i], SEMILLA)] = (PalabraClave)(i + 1);
+    }
+    return tabla;
+}
+
+constexpr TablaPalabras TABLA_PALABRAS = construirTabla();
+
+inline PalabraClave candidata(string_view palabra) {
+    if (palabra.empty()) return PalabraClave::NINGUNA;
+    return TABLA_PALABRAS.entradas[hashPalabra(palabra, SEMILLA)];
+}
+
+constexpr size_t NUM_OPERADORES = sizeof(OPERADORES) / sizeof(OPERADORES[0]);
+static_assert(NUM_OPERADORES == (size_t)Operador::COMA + 1, "Operador y OPERADORES no coinciden");
+
+struct TablaOperadores {
+    Operador entradas[256];
+};
+
+// Operadores de un carácter indexados por el propio carácter
+constexpr TablaOperadores construirOperadoresSimples() {
+    TablaOperadores tabla{};
+    for (size_t i = 1; i < NUM_OPERADORES; i++) {
+        if (OPERADORES[i].texto.size() == 1) {
+            tabla.entradas[(unsigned char)OPERADORES[i].texto[0]] = (Operador)i;
+        }
+    }
+    return tabla;
+}
+
+constexpr TablaOperadores OPERADORES_SIMPLES_TABLA = construirOperadoresSimples();
+constexpr const Operador* OPERADORES_SIMPLES = OPERADORES_SIMPLES_TABLA.entradas;
+
+inline Operador operadorDoble(char c, char d) {
+    if (d == '=') {
+        switch (c) {
+        case '<': return Operador::MENOR_IGUAL;
+        case '>': return Operador::MAYOR_IGUAL;
+        case '=': return Operador::IGUAL_IGUAL;
+        case '!': return Operador::DISTINTO;
+        }
+    }
+    return (c == '<' && d == '-') ? Operador::ASIGNACION : Operador::NINGUNO;
+}
+
+} // namespace
+
+PalabraClave buscarPalabraClave(string_view palabra) {
+    PalabraClave clave = candidata(palabra);
+    if (clave == PalabraClave::NINGUNA) return clave;
+    return PALABRAS_RESERVADAS[(size_t)clave - 1] == palabra ? clave : PalabraClave::NINGUNA;
+}
+
+PalabraClave buscarPalabraClaveSinMayusculas(string_view palabra) {
+    PalabraClave clave = candidata(palabra);
+    if (clave == PalabraClave::NINGUNA) return clave;
+    string_view esperada = PALABRAS_RESERVADAS[(size_t)clave - 1];
+    if (esperada.size() != palabra.size()) return PalabraClave::NINGUNA;
+    for (size_t i = 0; i < palabra.size(); i++) {
+        if (minuscula(esperada[i]) != minuscula(palabra[i])) return PalabraClave::NINGUNA;
+    }
+    return clave;
+}
+
+Lexer::Lexer(string_view codigo, bool ignorarMayusculas, TablaSimbolos* simbolos)
+    : codigo(codigo), i(0), linea(1), ignorarMayusculas(ignorarMayusculas), simbolos(simbolos) {}
+
+bool Lexer::siguiente(Token& token) {
+    const char* s = codigo.data();
     size_t n = codigo.length();
 
     while (i < n) {
+        char c = s[i];
+
         // Saltar espacios en blanco
-        if (isspace(codigo[i])) {
-            if (codigo[i] == '\n') linea++;
-            i++;
+        if (esClase(c, CLASE_ESPACIO)) {
+            i = saltarEspacios(s, i, n, linea);
             continue;
         }
 
-        // Comentarios (//)
-        if (i + 1 < n && codigo[i] == '/' && codigo[i+1] == '/') {
-            while (i < n && codigo[i] != '\n') i++;
-            linea++;
+        // Comentarios (//): el '\n' final lo cuenta el salto de espacios
+        if (c == '/' && i + 1 < n && s[i+1] == '/') {
+            i = buscarCaracter(s, i, n, '\n');
             continue;
         }
 
         // Identificadores y palabras reservadas
-        if (isalpha(codigo[i])) {
+        if (esClase(c, CLASE_LETRA)) {
             size_t start = i;
-            while (i < n && (isalnum(codigo[i]) || codigo[i] == '_')) i++;
-
-            string valor = codigo.substr(start, i - start);
-            TipoToken tipo = (find(PALABRAS_RESERVADAS.begin(), PALABRAS_RESERVADAS.end(), valor) != PALABRAS_RESERVADAS.end())
-                            ? PALABRA_RESERVADA : IDENTIFICADOR;
+            i = finIdentificador(s, i + 1, n);
 
-            tokens.push_back({tipo, valor, linea});
-            continue;
+            string_view valor = codigo.substr(start, i - start);
+            PalabraClave clave = ignorarMayusculas ? buscarPalabraClaveSinMayusculas(valor)
+                                                   : buscarPalabraClave(valor);
+            if (clave != PalabraClave::NINGUNA) {
+                token = {PALABRA_RESERVADA, valor, linea, clave};
+            } else {
+                token = {IDENTIFICADOR, valor, linea, clave, Operador::NINGUNO,
+                         simbolos ? simbolos->internar(valor) : SIN_SIMBOLO};
+            }
+            return true;
         }
 
         // Números
-        if (isdigit(codigo[i])) {
+        if (esClase(c, CLASE_DIGITO)) {
             size_t start = i;
-            while (i < n && isdigit(codigo[i])) i++;
-            tokens.push_back({NUMERO, codigo.substr(start, i - start), linea});
-            continue;
+            i = finDigitos(s, i + 1, n);
+            // Parte decimal (3.5); un punto sin dígitos detrás no es parte del número
+            if (i + 1 < n && s[i] == '.' && esClase(s[i+1], CLASE_DIGITO)) {
+                i = finDigitos(s, i + 2, n);
+            }
+            token = {NUMERO, codigo.substr(start, i - start), linea};
+            return true;
         }
 
         // Cadenas
-        if (codigo[i] == '"') {
+        if (c == '"') {
             size_t start = ++i;
-            while (i < n && codigo[i] != '"') {
-                if (codigo[i] == '\n') linea++;
-                i++;
-            }
-            tokens.push_back({CADENA, codigo.substr(start, i - start), linea});
+            i = buscarCaracter(s, i, n, '"');
+            linea += contarCaracter(s, start, i, '\n');
+            token = {CADENA, codigo.substr(start, i - start), linea};
             if (i < n) i++; // Saltar la comilla de cierre
-            continue;
+            return true;
         }
 
         // Operadores y símbolos
-        string op(1, codigo[i]);
         if (i + 1 < n) {
-            string posibleOp = op + codigo[i+1];
-            if (posibleOp == "<=" || posibleOp == ">=" || posibleOp == "==" || posibleOp == "!=" || posibleOp == "<-") {
-                tokens.push_back({OPERADOR, posibleOp, linea});
+            Operador doble = operadorDoble(c, s[i+1]);
+            if (doble != Operador::NINGUNO) {
+                token = {OPERADOR, codigo.substr(i, 2), linea, PalabraClave::NINGUNA, doble};
                 i += 2;
-                continue;
+                return true;
             }
         }
         
         // Operadores simples
-        if (op == "+" || op == "-" || op == "*" || op == "/" || op == "=" || 
-            op == "<" || op == ">" || op == "(" || op == ")" || op == ",") {
-            tokens.push_back({OPERADOR, op, linea});
-        } else {
-            tokens.push_back({SIMBOLO, op, linea});
-        }
+        Operador simple = OPERADORES_SIMPLES[(unsigned char)c];
+        token = {simple != Operador::NINGUNO ? OPERADOR : SIMBOLO, codigo.substr(i, 1), linea,
+                 PalabraClave::NINGUNA, simple};
         i++;
+        return true;
     }
 
+    return false;
+}
+
+vector<Token> analizarLexico(string_view codigo, bool ignorarMayusculas) {
+    vector<Token> tokens;
+    Lexer lexer(codigo, ignorarMayusculas);
+    Token token;
+    while (lexer.siguiente(token)) {
+        tokens.push_back(token);
+    }
     return tokens;
+}
+
+void BufferTokens::empezar(string_view texto) {
+    if (texto.size() > UINT32_MAX) throw length_error("El programa no cabe en un BufferTokens (4 GiB)");
+    this->texto = texto;
+    tipos.clear();
+    detalles.clear();
+    inicios.clear();
+    longitudes.clear();
+    simbolos.clear();
+    lineas.clear();
+}
+
+void BufferTokens::agregar(const Token& token) {
+    uint32_t indice = (uint32_t)tipos.size();
+    if (lineas.empty() || lineas.back().linea != token.linea) lineas.push_back({indice, token.linea});
+    tipos.push_back((uint8_t)token.tipo);
+    detalles.push_back(token.tipo == OPERADOR ? (uint8_t)token.op : (uint8_t)token.clave);
+    inicios.push_back((uint32_t)(token.valor.data() - texto.data()));
+    longitudes.push_back((uint32_t)token.valor.size());
+    simbolos.push_back(token.simbolo);
+}
+
+Token BufferTokens::token(size_t i) const {
+    // Última entrada de la tabla que empieza en o antes del token i
+    auto it = upper_bound(lineas.begin(), lineas.end(), i,
+                          [](size_t indice, const CambioLinea& cambio) { return indice < cambio.token; });
+    size_t cursor = it - lineas.begin() - 1;
+    return token(i, cursor);
+}
+
+Token BufferTokens::token(size_t i, size_t& cursor) const {
+    while (cursor + 1 < lineas.size() && lineas[cursor + 1].token <= i) cursor++;
+    Token resultado{tipo(i), valor(i), lineas[cursor].linea, PalabraClave::NINGUNA, Operador::NINGUNO, simbolos[i]};
+    if (resultado.tipo == OPERADOR) {
+        resultado.op = (Operador)detalles[i];
+    } else {
+        resultado.clave = (PalabraClave)detalles[i];
+    }
+    return resultado;
+}
+
+bool BufferTokens::empiezaLinea(size_t i, size_t& cursor) const {
+    while (cursor + 1 < lineas.size() && lineas[cursor + 1].token <= i) cursor++;
+    return lineas[cursor].token == i;
+}
+
+void analizarLexico(string_view codigo, BufferTokens& tokens, bool ignorarMayusculas, TablaSimbolos* simbolos) {
+    tokens.empezar(codigo);
+    Lexer lexer(codigo, ignorarMayusculas, simbolos);
+    Token token;
+    while (lexer.siguiente(token)) {
+        tokens.agregar(token);
+    }
+}
+
+namespace {
+
+// Parte [inicio, fin) del código para analizarLexicoParalelo
+struct TrozoLexico {
+    size_t inicio;
+    size_t fin;
+    BufferTokens tokens;       // posiciones respecto al código entero
+    TablaSimbolos simbolos;    // ids locales al trozo
+    vector<SimboloId> globales; // id local -> id en la tabla final
+    int saltos = 0;            // '\n' del trozo
+};
+
+void analizarTrozo(string_view codigo, TrozoLexico& trozo, bool ignorarMayusculas, bool conSimbolos) {
+    trozo.tokens.empezar(codigo);
+    trozo.simbolos.limpiar();
+    Lexer lexer(codigo.substr(trozo.inicio, trozo.fin - trozo.inicio), ignorarMayusculas,
+                conSimbolos ? &trozo.simbolos : nullptr);
+    Token token;
+    while (lexer.siguiente(token)) {
+        trozo.tokens.agregar(token);
+    }
+    trozo.saltos = lexer.lineaActual() - 1;
+}
+
+// La última cadena del trozo llega hasta su final sin comilla de cierre: el
+// corte cayó dentro de ella
+bool acabaEnCadena(string_view codigo, const TrozoLexico& trozo) {
+    size_t n = trozo.tokens.size();
+    if (n == 0 || trozo.tokens.tipo(n - 1) != CADENA) return false;
+    string_view valor = trozo.tokens.valor(n - 1);
+    return valor.data() + valor.size() == codigo.data() + trozo.fin;
+}
+
+} // namespace
+
+void analizarLexicoParalelo(string_view codigo, BufferTokens& tokens, unsigned hilos, bool ignorarMayusculas,
+                            TablaSimbolos* simbolos) {
+    size_t numTrozos = min<size_t>(hilos, codigo.size() / MIN_TROZO_LEXICO);
+    if (numTrozos <= 1) {
+        analizarLexico(codigo, tokens, ignorarMayusculas, simbolos);
+        return;
+    }
+    tokens.empezar(codigo);
+
+    // Cortes justo después de un '\n', repartidos a partes iguales
+    vector<TrozoLexico> trozos;
+    size_t inicio = 0;
+    for (size_t k = 1; k <= numTrozos && inicio < codigo.size(); k++) {
+        size_t fin = codigo.size();
+        if (k < numTrozos) {
+            size_t objetivo = max(inicio, codigo.size() / numTrozos * k);
+            fin = min(codigo.size(), buscarCaracter(codigo.data(), objetivo, codigo.size(), '\n') + 1);
+        }
+        trozos.emplace_back();
+        trozos.back().inicio = inicio;
+        trozos.back().fin = fin;
+        inicio = fin;
+    }
+
+    bool conSimbolos = simbolos != nullptr;
+    ejecutarConRobo(trozos.size(), hilos, [&](unsigned, size_t k) {
+        analizarTrozo(codigo, trozos[k], ignorarMayusculas, conSimbolos);
+    });
+
+    // Cada trozo se analizó suponiendo que empieza fuera de una cadena, lo que
+    // es cierto mientras el anterior no acabe dentro de una
+    for (size_t k = 0; k + 1 < trozos.size();) {
+        if (!acabaEnCadena(codigo, trozos[k])) {
+            k++;
+            continue;
+        }
+        trozos[k].fin = trozos[k + 1].fin;
+        trozos.erase(trozos.begin() + k + 1);
+        analizarTrozo(codigo, trozos[k], ignorarMayusculas, conSimbolos);
+    }
+
+    // Los ids globales siguen el orden de primera aparición, como en el
+    // análisis secuencial: los nombres de cada trozo se internan en orden
+    vector<size_t> primerToken(trozos.size() + 1, 0);
+    vector<size_t> primeraLinea(trozos.size() + 1, 0);
+    vector<int> lineasAntes(trozos.size(), 0);
+    for (size_t k = 0; k < trozos.size(); k++) {
+        TrozoLexico& trozo = trozos[k];
+        if (conSimbolos) {
+            trozo.globales.resize(trozo.simbolos.size());
+            for (SimboloId id = 0; id < trozo.simbolos.size(); id++) {
+                trozo.globales[id] = simbolos->internar(trozo.simbolos.nombre(id));
+            }
+        }
+        primerToken[k + 1] = primerToken[k] + trozo.tokens.size();
+        primeraLinea[k + 1] = primeraLinea[k] + trozo.tokens.lineas.size();
+        if (k + 1 < trozos.size()) lineasAntes[k + 1] = lineasAntes[k] + trozo.saltos;
+    }
+
+    size_t total = primerToken.back();
+    tokens.tipos.resize(total);
+    tokens.detalles.resize(total);
+    tokens.inicios.resize(total);
+    tokens.longitudes.resize(total);
+    tokens.simbolos.resize(total);
+    tokens.lineas.resize(primeraLinea.back());
+    ejecutarConRobo(trozos.size(), hilos, [&](unsigned, size_t k) {
+        const BufferTokens& origen = trozos[k].tokens;
+        size_t base = primerToken[k];
+        size_t n = origen.size();
+        memcpy(tokens.tipos.data() + base, origen.tipos.data(), n);
+        memcpy(tokens.detalles.data() + base, origen.detalles.data(), n);
+        memcpy(tokens.inicios.data() + base, origen.inicios.data(), n * sizeof(uint32_t));
+        memcpy(tokens.longitudes.data() + base, origen.longitudes.data(), n * sizeof(uint32_t));
+        for (size_t i = 0; i < n; i++) {
+            SimboloId id = origen.simbolos[i];
+            tokens.simbolos[base + i] = id == SIN_SIMBOLO ? id : trozos[k].globales[id];
+        }
+        for (size_t l = 0; l < origen.lineas.size(); l++) {
+            tokens.lineas[primeraLinea[k] + l] = {(uint32_t)(origen.lineas[l].token + base),
+                                                  origen.lineas[l].linea + lineasAntes[k]};
+        }
+    });
+}
+
+FlujoTokens::FlujoTokens(Lexer& lexer)
+    : lexer(&lexer), materializados(nullptr), buffer(nullptr), simbolos(lexer.tablaSimbolos()), posVector(0),
+      cursorLineas(0), cabeza(0), cantidad(0), agotado(false), ultimo{DESCONOCIDO, "", 0, PalabraClave::NINGUNA} {}
+
+FlujoTokens::FlujoTokens(const vector<Token>& tokens, TablaSimbolos* simbolos)
+    : lexer(nullptr), materializados(&tokens), buffer(nullptr), simbolos(simbolos), posVector(0),
+      cursorLineas(0), cabeza(0), cantidad(0), agotado(false), ultimo{DESCONOCIDO, "", 0, PalabraClave::NINGUNA} {}
+
+FlujoTokens::FlujoTokens(const BufferTokens& tokens, TablaSimbolos* simbolos)
+    : lexer(nullptr), materializados(nullptr), buffer(&tokens), simbolos(simbolos), posVector(0),
+      cursorLineas(0), cabeza(0), cantidad(0), agotado(false), ultimo{DESCONOCIDO, "", 0, PalabraClave::NINGUNA} {}
+
+bool FlujoTokens::rellenar(size_t k) {
+    while (cantidad <= k && !agotado) {
+        Token& destino = anillo[(cabeza + cantidad) % CAPACIDAD];
+        if (lexer) {
+            agotado = !lexer->siguiente(destino);
+        } else if (buffer) {
+            agotado = posVector >= buffer->size();
+            if (!agotado) destino = buffer->token(posVector++, cursorLineas);
+        } else if (posVector < materializados->size()) {
+            destino = (*materializados)[posVector++];
+        } else {
+            agotado = true;
+        }
+        if (!agotado) cantidad++;
+    }
+    return cantidad > k;
+}
+
+const Token& FlujoTokens::peek(size_t k) {
+    static const Token FIN = {DESCONOCIDO, "", 0, PalabraClave::NINGUNA};
+    return rellenar(k) ? anillo[(cabeza + k) % CAPACIDAD] : FIN;
+}
+
+Token FlujoTokens::consume() {
+    Token token = peek();
+    if (cantidad > 0) {
+        cabeza = (cabeza + 1) % CAPACIDAD;
+        cantidad--;
+        ultimo = token;
+    }
+    return token;
 }
\ No newline at end of file
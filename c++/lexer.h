@@ -1,8 +1,11 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "symbols.h"
 
 using namespace std;
 
@@ -18,16 +21,183 @@ enum TipoToken {
     DESCONOCIDO
 };
 
+// Mismo orden que PALABRAS_RESERVADAS (desplazado en uno por NINGUNA)
+enum class PalabraClave : uint8_t {
+    NINGUNA,
+    ALGORITMO, FIN_ALGORITMO, PROCESO, FIN_PROCESO,
+    SUBPROCESO, FIN_SUBPROCESO, SI, ENTONCES,
+    SINO, FIN_SI, SEGUN, FIN_SEGUN, PARA,
+    FIN_PARA, MIENTRAS, FIN_MIENTRAS, REPETIR,
+    HASTA, ESCRIBIR, LEER, FUNCION, FIN_FUNCION,
+    RETORNAR, VERDADERO, FALSO
+};
+
+// Operadores y signos de puntuación, en el mismo orden que OPERADORES
+enum class Operador : uint8_t {
+    NINGUNO,
+    SUMA, RESTA, MULTIPLICACION, DIVISION,
+    MENOR, MAYOR, MENOR_IGUAL, MAYOR_IGUAL,
+    IGUAL_IGUAL, DISTINTO, IGUAL, ASIGNACION,
+    PARENTESIS_ABRE, PARENTESIS_CIERRA, CORCHETE_ABRE, CORCHETE_CIERRA, COMA
+};
+
+// Precedencia de los operadores binarios de las expresiones (0 = no es
+// binario). Sigue a C++, así el generador puede escribir las operaciones sin
+// paréntesis salvo donde el árbol los necesita.
+struct InfoOperador {
+    string_view texto;
+    uint8_t precedencia;
+};
+
+constexpr InfoOperador OPERADORES[] = {
+    {"", 0},
+    {"+", 3}, {"-", 3}, {"*", 4}, {"/", 4},
+    {"<", 2}, {">", 2}, {"<=", 2}, {">=", 2},
+    {"==", 1}, {"!=", 1}, {"=", 0}, {"<-", 0},
+    {"(", 0}, {")", 0}, {"[", 0}, {"]", 0}, {",", 0}
+};
+
+constexpr uint8_t precedencia(Operador op) {
+    return OPERADORES[(size_t)op].precedencia;
+}
+
+// `valor` apunta dentro del código fuente analizado: el buffer (string o
+// archivo mapeado) debe seguir vivo mientras se usen los tokens.
 struct Token {
     TipoToken tipo;
-    string valor;
+    string_view valor;
+    int linea;
+    PalabraClave clave = PalabraClave::NINGUNA; // solo para PALABRA_RESERVADA
+    Operador op = Operador::NINGUNO;            // solo para OPERADOR
+    SimboloId simbolo = SIN_SIMBOLO; // solo para IDENTIFICADOR, si el lexer tiene tabla
+};
+
+// Con ignorarMayusculas, "algoritmo" o "FINSI" también son palabras reservadas
+// (la transcripción de voz lo genera todo en minúsculas).
+vector<Token> analizarLexico(string_view codigo, bool ignorarMayusculas = false);
+
+// Lexer incremental: produce un token por llamada, sin guardar los anteriores.
+class Lexer {
+public:
+    // Con `simbolos`, cada identificador sale ya con su id de la tabla
+    Lexer(string_view codigo, bool ignorarMayusculas = false, TablaSimbolos* simbolos = nullptr);
+
+    // Devuelve false cuando no quedan tokens.
+    bool siguiente(Token& token);
+    TablaSimbolos* tablaSimbolos() const { return simbolos; }
+    // Línea por la que va (al terminar, 1 + los '\n' del código)
+    int lineaActual() const { return linea; }
+
+private:
+    string_view codigo;
+    size_t i;
     int linea;
+    bool ignorarMayusculas;
+    TablaSimbolos* simbolos;
 };
 
-vector<Token> analizarLexico(const string& codigo);
+// Tokens ya analizados guardados por columnas (structure of arrays): tipo y
+// clave/operador en un byte, posición y longitud en el texto en 4 bytes, y una
+// tabla de líneas con una entrada por cada token que empieza línea nueva. Los
+// valores apuntan al texto, que debe seguir vivo y medir menos de 4 GiB.
+class BufferTokens {
+public:
+    // Vacía el buffer (conservando la memoria) para analizar `texto`
+    void empezar(string_view texto);
+    void agregar(const Token& token);
+    size_t size() const { return tipos.size(); }
+    bool empty() const { return tipos.empty(); }
+
+    TipoToken tipo(size_t i) const { return (TipoToken)tipos[i]; }
+    string_view valor(size_t i) const { return texto.substr(inicios[i], longitudes[i]); }
+    // PalabraClave de una PALABRA_RESERVADA u Operador de un OPERADOR
+    uint8_t detalle(size_t i) const { return detalles[i]; }
+    Token token(size_t i) const;
+    // Para recorridos en orden: `cursor` (empezando en 0) avanza por la
+    // tabla de líneas en vez de buscar en ella
+    Token token(size_t i, size_t& cursor) const;
+    // Si el token i empieza línea nueva, con un cursor como el de token(i, cursor)
+    bool empiezaLinea(size_t i, size_t& cursor) const;
+
+private:
+    friend void analizarLexicoParalelo(string_view, BufferTokens&, unsigned, bool, TablaSimbolos*);
+
+    struct CambioLinea {
+        uint32_t token; // primer token de la línea
+        int linea;
+    };
+
+    string_view texto;
+    vector<uint8_t> tipos;
+    vector<uint8_t> detalles;
+    vector<uint32_t> inicios;
+    vector<uint32_t> longitudes;
+    vector<SimboloId> simbolos;
+    vector<CambioLinea> lineas;
+};
+
+// Analiza `codigo` entero en `tokens` (reutilizando su memoria)
+void analizarLexico(string_view codigo, BufferTokens& tokens, bool ignorarMayusculas = false,
+                    TablaSimbolos* simbolos = nullptr);
+
+// Tamaño mínimo de cada trozo del léxico en paralelo: por debajo no compensa
+// lanzar hilos
+constexpr size_t MIN_TROZO_LEXICO = 256 * 1024;
+
+// Igual que analizarLexico pero en `hilos` trozos a la vez, cortando el código
+// en saltos de línea. Fuera de las cadenas el lexer no arrastra estado de una
+// línea a otra (un comentario // acaba en el '\n'), así que cada trozo se
+// analiza por separado; si un corte cae dentro de una cadena, ese trozo se une
+// con el siguiente y se repite. Los tokens, las líneas y los ids de símbolo
+// salen idénticos a los del análisis secuencial.
+void analizarLexicoParalelo(string_view codigo, BufferTokens& tokens, unsigned hilos,
+                            bool ignorarMayusculas = false, TablaSimbolos* simbolos = nullptr);
+
+// Flujo de tokens para el parser con un anillo de lookahead de tamaño fijo.
+// Los tokens se piden al Lexer a medida que se consumen; también puede leer
+// de un vector o un BufferTokens ya materializados.
+class FlujoTokens {
+public:
+    static constexpr size_t CAPACIDAD = 4;
+
+    explicit FlujoTokens(Lexer& lexer);
+    // `simbolos`: la tabla con la que se analizaron los tokens, si se usó alguna
+    explicit FlujoTokens(const vector<Token>& tokens, TablaSimbolos* simbolos = nullptr);
+    explicit FlujoTokens(const BufferTokens& tokens, TablaSimbolos* simbolos = nullptr);
+
+    // k < CAPACIDAD. Al terminar devuelve un token DESCONOCIDO vacío.
+    const Token& peek(size_t k = 0);
+    Token consume();
+    bool fin() { return !rellenar(0); }
+    // Tabla de los ids de los tokens (nullptr si no llevan)
+    TablaSimbolos* tablaSimbolos() const { return simbolos; }
+    // Último token consumido (tipo DESCONOCIDO si todavía no se consumió ninguno)
+    const Token& ultimoConsumido() const { return ultimo; }
+    // Hasta dónde ha leído el parser (para la compilación incremental): true si
+    // el lexer llegó al final; si no, ultimoLeido() es el token más lejano pedido.
+    bool leidoHastaElFinal() const { return agotado; }
+    const Token& ultimoLeido() const {
+        return cantidad > 0 ? anillo[(cabeza + cantidad - 1) % CAPACIDAD] : ultimo;
+    }
+
+private:
+    bool rellenar(size_t k);
+
+    Lexer* lexer;
+    const vector<Token>* materializados;
+    const BufferTokens* buffer;
+    TablaSimbolos* simbolos;
+    size_t posVector;
+    size_t cursorLineas;
+    Token anillo[CAPACIDAD];
+    size_t cabeza;
+    size_t cantidad;
+    bool agotado;
+    Token ultimo;
+};
 
 // Palabras reservadas del pseudocódigo
-const vector<string> PALABRAS_RESERVADAS = {
+constexpr string_view PALABRAS_RESERVADAS[] = {
     "Algoritmo", "FinAlgoritmo", "Proceso", "FinProceso",
     "SubProceso", "FinSubProceso", "Si", "Entonces",
     "Sino", "FinSi", "Segun", "FinSegun", "Para",
@@ -36,4 +206,9 @@ const vector<string> PALABRAS_RESERVADAS = {
     "Retornar", "Verdadero", "Falso"
 };
 
+// Búsqueda O(1) con un hash perfecto generado en tiempo de compilación.
+// Devuelven PalabraClave::NINGUNA si `palabra` no es reservada.
+PalabraClave buscarPalabraClave(string_view palabra);
+PalabraClave buscarPalabraClaveSinMayusculas(string_view palabra);
+
 #endif
\ No newline at end of file
@@ -1,41 +1,262 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include "lexer.h"
-#include "parser.h"
-#include "generator.h"
+#include <vector>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include "compiler.h"
+#include "server.h"
+#include "stats.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 using namespace std;
 
-int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        cerr << "Uso: " << argv[0] << " <archivo.pseudo>" << endl;
-        return 1;
-    }
+static void mostrarUso(const char* programa) {
+    cerr << "Uso: " << programa <<  " [--ignorar-mayusculas] [--stdout] [-j hilos] <archivo.pseudo>" << endl;
+    cerr << "     " << programa << " [--ignorar-mayusculas] [-j hilos] <archivo|directorio>... [--lista manifiesto]" << endl;
+    cerr << "     " << programa << " [--ignorar-mayusculas] [--incremental] --servidor | --socket <ruta>" << endl;
+    cerr << "Caché de compilación: --cache (en memoria) o --cache-dir <directorio> (también en disco)" << endl;
+    cerr << "Plegado de constantes y eliminación de ramas muertas: --optimizar" << endl;
+    cerr << "E/S rápida en el programa generado: --fast-io (sin sincronizar con stdio) o --fast-io=buffer" << endl;
+    cerr << "Bucles Para independientes con OpenMP (compilar el C++ con -fopenmp): --paralelizar" << endl;
+    cerr << "Pistas de vectorización (#pragma omp simd, con -fopenmp o -fopenmp-simd): --vectorizar" << endl;
+    cerr << "Medidas por fase en stderr: --stats (texto) o --stats=json" << endl;
+    cerr << "Árbol analizado en binario (.ast) en vez de C++: --ast; un .ast como entrada genera su C++" << endl;
+    cerr << "Ejecutar al momento con el intérprete, sin g++: --ejecutar [--limite-pasos N] <archivo>" << endl;
+}
 
-    string filename = argv[1];
-    string sourceCode = leerArchivo(filename);
+// Límite de pasos del intérprete: el programa ya no es de ejecución inmediata
+const int SALIDA_LIMITE_PASOS = 3;
 
+// --ejecutar: el programa lee de stdin y escribe en stdout como el C++ generado
+static int ejecutarPrograma(Compilador& compilador, const string& filename, const OpcionesEjecucion& ejecucion) {
+    ArchivoMapeado archivo(filename);
+    string_view sourceCode = archivo.contenido();
     if (sourceCode.empty()) {
         cerr << "Error: No se pudo leer el archivo o está vacío." << endl;
         return 1;
     }
+    ios::sync_with_stdio(false);
+    int estado = 0;
+    try {
+        compilador.ejecutar(sourceCode, cin, cout, ejecucion);
+    } catch (const LimitePasosAlcanzado& e) {
+        cout.flush();
+        cerr << "Aviso: " << e.what() << endl;
+        estado = SALIDA_LIMITE_PASOS;
+    } catch (const exception& e) {
+        cout.flush();
+        cerr << "Error: " << e.what() << endl;
+        estado = 1;
+    }
+    cout.flush();
+    return estado;
+}
+
+enum class FormatoEstadisticas { NINGUNO, TEXTO, JSON };
+
+static void informarEstadisticas(FormatoEstadisticas formato, const vector<ResultadoCompilacion>& resultados,
+                                 chrono::steady_clock::time_point inicio) {
+    if (formato == FormatoEstadisticas::NINGUNO) return;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    EstadisticasCompilacion total;
+    for (const ResultadoCompilacion& resultado : resultados) {
+        total.acumular(resultado.estadisticas);
+    }
+    if (formato == FormatoEstadisticas::JSON) {
+        escribirEstadisticasJson(cerr, total, ms, resultados);
+    } else {
+        escribirEstadisticasTexto(cerr, total, ms);
+    }
+}
+
+// Modo por lotes: un solo proceso, un Compilador por hilo
+static int ejecutarLote(const vector<string>& entradas, const OpcionesCompilacion& opciones, unsigned hilos,
+                        FormatoEstadisticas formato) {
+    auto inicio = chrono::steady_clock::now();
+    vector<ResultadoCompilacion> resultados = compilarLote(entradas, opciones, hilos);
+    size_t correctos = 0;
+    size_t bytes = 0;
+
+    for (const ResultadoCompilacion& resultado : resultados) {
+        bytes += resultado.bytesEntrada;
+        if (resultado.exito) {
+            correctos++;
+        } else {
+            cerr << "Error en " << resultado.entrada << ": " << resultado.error << endl;
+        }
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    cout << "Lote: " << entradas.size() << " archivos, " << correctos << " compilados, "
+         << (entradas.size() - correctos) << " con errores (" << bytes << " bytes en "
+         << ms << " ms)";
+    if (opciones.cache) {
+        cout << ", caché: " << opciones.cache->aciertos() << " aciertos, "
+             << opciones.cache->fallos() << " fallos";
+    }
+    cout << endl;
+    informarEstadisticas(formato, resultados, inicio);
+
+    return correctos == entradas.size() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    auto inicio = chrono::steady_clock::now();
+    OpcionesCompilacion opciones;
+    FormatoEstadisticas formato = FormatoEstadisticas::NINGUNO;
+    bool aSalidaEstandar = false;
+    unsigned hilos = hilosDisponibles();
+    vector<string> rutas;
+    vector<string> manifiestos;
+    bool modoServidor = false;
+    string rutaSocket;
+    bool usarCache = false;
+    string directorioCache;
+    bool ejecutar = false;
+    OpcionesEjecucion ejecucion;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ignorar-mayusculas") {
+            opciones.ignorarMayusculas = true;
+        } else if (arg == "--stdout") {
+            aSalidaEstandar = true;
+        } else if (arg == "--lista" && i + 1 < argc) {
+            manifiestos.push_back(argv[++i]);
+        } else if (arg == "--cache") {
+            usarCache = true;
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            usarCache = true;
+            directorioCache = argv[++i];
+        } else if (arg == "--optimizar") {
+            opciones.optimizar = true;
+        } else if (arg == "--fast-io") {
+            opciones.codigo.entradaSalida = ModoES::RAPIDA;
+        } else if (arg == "--fast-io=buffer") {
+            opciones.codigo.entradaSalida = ModoES::BUFFER;
+        } else if (arg == "--paralelizar") {
+            opciones.codigo.paralelizar = true;
+        } else if (arg == "--vectorizar") {
+            opciones.codigo.vectorizar = true;
+        } else if (arg == "--stats") {
+            formato = FormatoEstadisticas::TEXTO;
+        } else if (arg == "--stats=json") {
+            formato = FormatoEstadisticas::JSON;
+        } else if (arg == "--ast") {
+            opciones.emitirAST = true;
+        } else if (arg == "--ejecutar") {
+            ejecutar = true;
+        } else if (arg == "--limite-pasos" && i + 1 < argc) {
+            ejecucion.limitePasos = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--incremental") {
+            opciones.incremental = true;
+        } else if (arg == "--servidor") {
+            modoServidor = true;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            rutaSocket = argv[++i];
+        } else if (arg == "-j" && i + 1 < argc) {
+            hilos = (unsigned)max(1, atoi(argv[++i]));
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            mostrarUso(argv[0]);
+            return 1;
+        } else {
+            rutas.push_back(arg);
+        }
+    }
+
+    if (formato != FormatoEstadisticas::NINGUNO) {
+        opciones.estadisticas = true;
+        activarContadorMemoria();
+    }
+
+    unique_ptr<CacheCompilacion> cache;
+    if (usarCache) {
+        cache = make_unique<CacheCompilacion>(directorioCache);
+        opciones.cache = cache.get();
+    }
+
+    if (!rutaSocket.empty()) {
+        return servirSocket(rutaSocket, opciones);
+    }
+    if (modoServidor) {
+        return servirEntradaEstandar(opciones);
+    }
+
+    if (rutas.empty() && manifiestos.empty()) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    error_code ec;
+    if (rutas.size() != 1 || !manifiestos.empty() || filesystem::is_directory(rutas[0], ec)) {
+        if (aSalidaEstandar || ejecutar) {
+            cerr << "Error: " << (ejecutar ? "--ejecutar" : "--stdout") << " solo admite un archivo." << endl;
+            return 1;
+        }
+        vector<string> entradas;
+        try {
+            entradas = expandirEntradas(rutas, manifiestos);
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+        return ejecutarLote(entradas, opciones, hilos, formato);
+    }
 
-    // Fase 1: Análisis léxico
-    vector<Token> tokens = analizarLexico(sourceCode);
+    string filename = rutas[0];
+    // Con un solo archivo los hilos se usan en el léxico (si es grande) y en
+    // la generación de los SubProceso
+    opciones.hilosLexico = hilos;
+    opciones.codigo.hilos = hilos;
+    Compilador compilador(opciones);
 
-    // Fase 2: Análisis sintáctico
-    NodoAST* arbol = analizarSintaxis(tokens);
+    if (ejecutar) {
+        return ejecutarPrograma(compilador, filename, ejecucion);
+    }
 
-    // Fase 3: Generación de código
-    string codigoCpp = generarCodigo(arbol);
+    if (aSalidaEstandar) {
+        ArchivoMapeado archivo(filename);
+        string_view sourceCode = archivo.contenido();
+        if (sourceCode.empty()) {
+            cerr << "Error: No se pudo leer el archivo o está vacío." << endl;
+            return 1;
+        }
+        // La generación escribe por bloques directamente a stdout
+        Emisor salida(stdout);
+        try {
+            compilador.compilar(sourceCode, salida);
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+        salida.vaciar();
+        ResultadoCompilacion resultado;
+        resultado.entrada = filename;
+        resultado.exito = !salida.fallo();
+        resultado.bytesEntrada = sourceCode.size();
+        resultado.estadisticas = compilador.estadisticas();
+        informarEstadisticas(formato, {resultado}, inicio);
+        return resultado.exito ? 0 : 1;
+    }
 
-    // Guardar el resultado
-    string outputFilename = cambiarExtension(filename, ".cpp");
-    guardarArchivo(outputFilename, codigoCpp);
+    ResultadoCompilacion resultado = compilador.compilarArchivo(filename);
+    informarEstadisticas(formato, {resultado}, inicio);
+    if (!resultado.exito) {
+        cerr << "Error: " << resultado.error << endl;
+        return 1;
+    }
+    cout << "Archivo guardado en: " << resultado.salida << endl;
 
-    cout << "Compilación exitosa. Código C++ generado en: " << outputFilename << endl;
+    string outputFilename = archivoSalida(filename, opciones);
+    if (opciones.emitirAST) {
+        cout << "Análisis exitoso. Árbol serializado en: " << outputFilename << endl;
+    } else {
+        cout << "Compilación exitosa. Código C++ generado en: " << outputFilename << endl;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,123 @@
+#include "optimizer.h"
+#include <charconv>
+#include <climits>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+class Optimizador {
+public:
+    explicit Optimizador(ArbolAST& arbol) : arbol(arbol) {}
+
+    NodoId optimizar(NodoId id) {
+        if (id == NODO_NULO) return id;
+
+        switch (arbol[id].tipo) {
+        case TipoNodo::PROGRAMA:
+        case TipoNodo::ALGORITMO:
+        case TipoNodo::BLOQUE:
+            optimizarSentencias(id);
+            return id;
+        case TipoNodo::SI:
+            return optimizarSi(id);
+        case TipoNodo::MIENTRAS:
+            return optimizarMientras(id);
+        case TipoNodo::OPERACION_BINARIA:
+            return plegar(id);
+        default:
+            optimizarHijos(id);
+            return id;
+        }
+    }
+
+private:
+    ArbolAST& arbol;
+
+    NodoId* hijos(NodoId id) {
+        return arbol.hijos.data() + arbol.nodos[id].primerHijo;
+    }
+
+    void optimizarHijos(NodoId id) {
+        for (uint32_t i = 0; i < arbol.nodos[id].numHijos; i++) {
+            NodoId hijo = hijos(id)[i];
+            hijos(id)[i] = optimizar(hijo);
+        }
+    }
+
+    // Las sentencias eliminadas se quitan compactando el rango de hijos
+    void optimizarSentencias(NodoId id) {
+        uint32_t quedan = 0;
+        for (uint32_t i = 0; i < arbol.nodos[id].numHijos; i++) {
+            NodoId hijo = optimizar(hijos(id)[i]);
+            if (hijo != NODO_NULO) hijos(id)[quedan++] = hijo;
+        }
+        arbol.nodos[id].numHijos = quedan;
+    }
+
+    bool constante(NodoId id, long long& valor) {
+        const NodoAST& nodo = arbol[id];
+        if (nodo.tipo != TipoNodo::NUMERO) return false;
+        const char* fin = nodo.valor.data() + nodo.valor.size();
+        auto [ptr, ec] = from_chars(nodo.valor.data(), fin, valor);
+        return ec == errc() && ptr == fin && valor >= INT_MIN && valor <= INT_MAX;
+    }
+
+    bool calcular(Operador op, long long a, long long b, long long& resultado) {
+        switch (op) {
+        case Operador::SUMA: resultado = a + b; break;
+        case Operador::RESTA: resultado = a - b; break;
+        case Operador::MULTIPLICACION: resultado = a * b; break;
+        case Operador::DIVISION:
+            if (b == 0) return false;
+            resultado = a / b;
+            break;
+        case Operador::MENOR: resultado = a < b; break;
+        case Operador::MAYOR: resultado = a > b; break;
+        case Operador::MENOR_IGUAL: resultado = a <= b; break;
+        case Operador::MAYOR_IGUAL: resultado = a >= b; break;
+        case Operador::IGUAL_IGUAL: resultado = a == b; break;
+        case Operador::DISTINTO: resultado = a != b; break;
+        default: return false;
+        }
+        return resultado >= INT_MIN && resultado <= INT_MAX;
+    }
+
+    NodoId plegar(NodoId id) {
+        optimizarHijos(id);
+        const NodoAST& nodo = arbol[id];
+        long long a, b, resultado;
+        if (nodo.numHijos != 2 || !constante(hijos(id)[0], a) || !constante(hijos(id)[1], b) ||
+            !calcular(nodo.operador, a, b, resultado)) {
+            return id;
+        }
+        return arbol.crearHoja(TipoNodo::NUMERO, arbol.guardarTexto(to_string(resultado)));
+    }
+
+    // Hijos de SI: condición, bloque then y (opcional) bloque else
+    NodoId optimizarSi(NodoId id) {
+        optimizarHijos(id);
+        long long condicion;
+        if (arbol[id].numHijos < 2 || !constante(hijos(id)[0], condicion)) return id;
+        if (condicion != 0) return hijos(id)[1];
+        return arbol[id].numHijos > 2 ? hijos(id)[2] : NODO_NULO;
+    }
+
+    NodoId optimizarMientras(NodoId id) {
+        optimizarHijos(id);
+        long long condicion;
+        if (arbol[id].numHijos >= 1 && constante(hijos(id)[0], condicion) && condicion == 0) return NODO_NULO;
+        return id;
+    }
+};
+
+} // namespace
+
+NodoId optimizarArbol(ArbolAST& arbol, NodoId raiz) {
+    return Optimizador(arbol).optimizar(raiz);
+}
+
+void optimizarArbol(ArbolAST& arbol) {
+    arbol.raiz = optimizarArbol(arbol, arbol.raiz);
+}
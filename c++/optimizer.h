@@ -0,0 +1,19 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "ast.h"
+
+using namespace std;
+
+// Pase opcional entre analizarSintaxis y generarCodigo (--optimizar):
+//  - pliega OPERACION_BINARIA cuyos operandos son NUMERO (aritmética de int
+//    como en el C++ generado; no pliega si desborda o divide por cero),
+//  - sustituye los Si de condición constante por la rama que se ejecuta,
+//  - elimina los Mientras de condición constante falsa.
+// Los valores nuevos se guardan en el pool de textos del árbol.
+void optimizarArbol(ArbolAST& arbol);
+// Igual sobre el subárbol de `raiz`; devuelve la nueva raíz (NODO_NULO si la
+// sentencia desaparece).
+NodoId optimizarArbol(ArbolAST& arbol, NodoId raiz);
+
+#endif
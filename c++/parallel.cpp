@@ -0,0 +1,286 @@
+#include "parallel.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// Una llamada puede escribir, leer o modificar sus argumentos por referencia
+bool contieneLlamada(const ArbolAST& arbol, NodoId id) {
+    if (id == NODO_NULO) return false;
+    if (arbol[id].tipo == TipoNodo::LLAMADA) return true;
+    for (NodoId hijo : arbol.hijosDe(id)) {
+        if (contieneLlamada(arbol, hijo)) return true;
+    }
+    return false;
+}
+
+class AnalisisParalelo {
+public:
+    AnalisisParalelo(const ArbolAST& arbol, const ConjuntoSimbolos& declaradas, vector<Reduccion>& reducciones,
+                     MemoriaParalelismo& memoria)
+        : arbol(arbol), declaradas(declaradas), reducciones(reducciones), lecturas(memoria.lecturas),
+          lecturasArreglo(memoria.lecturasArreglo), escritos(memoria.escritos) {
+        lecturas.clear();
+        lecturasArreglo.clear();
+        escritos.clear();
+    }
+
+    bool analizar(NodoId para) {
+        const NodoAST& nodo = arbol[para];
+        RangoHijos hijos = arbol.hijosDe(para);
+        // Sin Hasta no hay límite que repartir entre los hilos
+        if (hijos.size() < 3) return false;
+        if (nodo.tipoDato != TipoDato::DESCONOCIDO && nodo.tipoDato != TipoDato::ENTERO &&
+            nodo.tipoDato != TipoDato::ENTERO_LARGO) {
+            return false;
+        }
+
+        variablePara = nodo.valor;
+        reducciones.clear();
+        if (contieneLlamada(arbol, para)) return false;
+        if (!sentencia(hijos[2])) return false;
+
+        // Los límites se evalúan una sola vez en el bucle paralelo
+        if (usaAsignada(hijos[0]) || usaAsignada(hijos[1])) return false;
+        for (string_view leida : lecturas) {
+            if (buscarReduccion(leida)) return false;
+        }
+        // Un arreglo que se escribe solo puede leerse en la posición de la iteración
+        for (const LecturaArreglo& lectura : lecturasArreglo) {
+            if (escrito(lectura.arreglo) && !esContador(lectura.indice)) return false;
+        }
+        return true;
+    }
+
+private:
+    const ArbolAST& arbol;
+    const ConjuntoSimbolos& declaradas;
+    vector<Reduccion>& reducciones;
+    string_view variablePara;
+    typedef MemoriaParalelismo::LecturaArreglo LecturaArreglo;
+    vector<string_view>& lecturas;
+    vector<LecturaArreglo>& lecturasArreglo;
+    vector<string_view>& escritos;
+
+    bool escrito(string_view arreglo) const {
+        return find(escritos.begin(), escritos.end(), arreglo) != escritos.end();
+    }
+
+    bool esContador(NodoId indice) const {
+        return arbol[indice].tipo == TipoNodo::IDENTIFICADOR && arbol[indice].valor == variablePara;
+    }
+
+    Reduccion* buscarReduccion(string_view variable) {
+        for (Reduccion& reduccion : reducciones) {
+            if (reduccion.variable == variable) return &reduccion;
+        }
+        return nullptr;
+    }
+
+    bool usaAsignada(NodoId id) {
+        if (id == NODO_NULO) return false;
+        if (arbol[id].tipo == TipoNodo::IDENTIFICADOR) return buscarReduccion(arbol[id].valor) != nullptr;
+        if (arbol[id].tipo == TipoNodo::ELEMENTO && escrito(arbol[id].valor)) return true;
+        for (NodoId hijo : arbol.hijosDe(id)) {
+            if (usaAsignada(hijo)) return true;
+        }
+        return false;
+    }
+
+    bool contiene(NodoId id, string_view variable) const {
+        if (id == NODO_NULO) return false;
+        if (arbol[id].tipo == TipoNodo::IDENTIFICADOR) return arbol[id].valor == variable;
+        for (NodoId hijo : arbol.hijosDe(id)) {
+            if (contiene(hijo, variable)) return true;
+        }
+        return false;
+    }
+
+    void leer(NodoId id) {
+        if (id == NODO_NULO) return;
+        if (arbol[id].tipo == TipoNodo::IDENTIFICADOR) {
+            lecturas.push_back(arbol[id].valor);
+            return;
+        }
+        if (arbol[id].tipo == TipoNodo::ELEMENTO && arbol[id].numHijos > 0) {
+            lecturasArreglo.push_back({arbol[id].valor, arbol.hijosDe(id)[0]});
+        }
+        for (NodoId hijo : arbol.hijosDe(id)) {
+            leer(hijo);
+        }
+    }
+
+    bool sentencias(NodoId id) {
+        for (NodoId hijo : arbol.hijosDe(id)) {
+            if (!sentencia(hijo)) return false;
+        }
+        return true;
+    }
+
+    bool sentencia(NodoId id) {
+        if (id == NODO_NULO) return true;
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+
+        switch (nodo.tipo) {
+        case TipoNodo::ESCRIBIR:
+        case TipoNodo::LEER:
+            return false;
+        case TipoNodo::ASIGNACION:
+            return asignacion(id);
+        case TipoNodo::SI:
+        case TipoNodo::MIENTRAS:
+            if (!hijos.empty()) leer(hijos[0]); // condición
+            for (size_t i = 1; i < hijos.size(); i++) {
+                if (!sentencia(hijos[i])) return false;
+            }
+            return true;
+        case TipoNodo::PARA:
+            // El for anidado declara su propia variable; sus límites se leen
+            lecturas.push_back(nodo.valor);
+            for (size_t i = 0; i < hijos.size(); i++) {
+                if (i < 2) {
+                    leer(hijos[i]);
+                } else if (!sentencia(hijos[i])) {
+                    return false;
+                }
+            }
+            return true;
+        case TipoNodo::BLOQUE:
+            return sentencias(id);
+        case TipoNodo::DIMENSION:
+            // Un arreglo creado en el cuerpo es de la iteración; redimensionar uno de fuera no
+            if (declaradas.contiene(nodo.simbolo)) return false;
+            if (!hijos.empty()) leer(hijos[0]);
+            return true;
+        default:
+            // DECLARACION dentro del cuerpo: local a cada iteración
+            return true;
+        }
+    }
+
+    bool asignacion(NodoId id) {
+        const NodoAST& nodo = arbol[id];
+        if (nodo.valor == variablePara) return false;
+        if (nodo.numHijos == 0) return true;
+        NodoId expresion = arbol.hijosDe(id)[0];
+
+        // a[i] <- expr: cada iteración escribe su propio elemento
+        if (nodo.numHijos > 1) {
+            if (!esContador(arbol.hijosDe(id)[1])) return false;
+            if (!escrito(nodo.valor)) escritos.push_back(nodo.valor);
+            leer(expresion);
+            return true;
+        }
+
+        // Variable nueva: se declara en el cuerpo y es privada de la iteración
+        if (!declaradas.contiene(nodo.simbolo)) {
+            leer(expresion);
+            return true;
+        }
+
+        // Variable de fuera: solo vale como acumulación
+        const NodoAST& operacion = arbol[expresion];
+        if (operacion.tipo != TipoNodo::OPERACION_BINARIA || operacion.numHijos < 2) return false;
+        if (nodo.tipoDato == TipoDato::CADENA) return false;
+        NodoId izquierdo = arbol.hijosDe(expresion)[0];
+        NodoId derecho = arbol.hijosDe(expresion)[1];
+        auto esLaVariable = [&](NodoId operando) {
+            return arbol[operando].tipo == TipoNodo::IDENTIFICADOR && arbol[operando].valor == nodo.valor;
+        };
+
+        char operador;
+        NodoId resto;
+        if (operacion.operador == Operador::SUMA || operacion.operador == Operador::MULTIPLICACION) {
+            operador = operacion.operador == Operador::SUMA ? '+' : '*';
+            if (esLaVariable(izquierdo)) {
+                resto = derecho;
+            } else if (esLaVariable(derecho)) {
+                resto = izquierdo;
+            } else {
+                return false;
+            }
+        } else if (operacion.operador == Operador::RESTA && esLaVariable(izquierdo)) {
+            // Cada hilo parte de 0 y resta; sumar los parciales da el total
+            operador = '+';
+            resto = derecho;
+        } else {
+            return false;
+        }
+        if (contiene(resto, nodo.valor)) return false;
+
+        if (Reduccion* previa = buscarReduccion(nodo.valor)) {
+            if (previa->operador != operador) return false;
+        } else {
+            reducciones.push_back({nodo.valor, operador});
+        }
+        leer(resto);
+        return true;
+    }
+};
+
+} // namespace
+
+bool analizarParalelismo(const ArbolAST& arbol, NodoId para, const ConjuntoSimbolos& declaradas,
+                         vector<Reduccion>& reducciones, MemoriaParalelismo& memoria) {
+    AnalisisParalelo analisis(arbol, declaradas, reducciones, memoria);
+    return analisis.analizar(para);
+}
+
+bool cuerpoLineal(const ArbolAST& arbol, NodoId para) {
+    RangoHijos hijos = arbol.hijosDe(para);
+    if (hijos.size() < 3) return false;
+    for (NodoId sentencia : arbol.hijosDe(hijos[2])) {
+        if (arbol[sentencia].tipo != TipoNodo::ASIGNACION) return false;
+    }
+    return true;
+}
+
+bool limiteInvariante(const ArbolAST& arbol, NodoId para, MemoriaParalelismo& memoria) {
+    RangoHijos hijos = arbol.hijosDe(para);
+    // Una llamada del cuerpo puede cambiar el límite por un parámetro Por Referencia
+    if (hijos.size() < 3 || contieneLlamada(arbol, hijos[1]) || contieneLlamada(arbol, hijos[2])) return false;
+    vector<string_view>& modificadas = memoria.modificadas;
+    modificadas.assign(1, arbol[para].valor); // el contador cambia en cada vuelta
+    vector<NodoId>& pendientes = memoria.pendientes;
+    pendientes.assign(1, hijos[2]);
+    while (!pendientes.empty()) {
+        NodoId id = pendientes.back();
+        pendientes.pop_back();
+        const NodoAST& nodo = arbol[id];
+        if (nodo.tipo == TipoNodo::ASIGNACION || nodo.tipo == TipoNodo::PARA || nodo.tipo == TipoNodo::DIMENSION ||
+            nodo.tipo == TipoNodo::DECLARACION) {
+            modificadas.push_back(nodo.valor);
+        } else if (nodo.tipo == TipoNodo::LEER && nodo.numHijos > 0) {
+            modificadas.push_back(arbol[arbol.hijosDe(id)[0]].valor);
+        }
+        for (NodoId hijo : arbol.hijosDe(id)) pendientes.push_back(hijo);
+    }
+    for (string_view nombre : modificadas) {
+        if (usaNombre(arbol, hijos[1], nombre)) return false;
+    }
+    return true;
+}
+
+bool usaNombre(const ArbolAST& arbol, NodoId raiz, string_view nombre) {
+    if (raiz == NODO_NULO) return false;
+    const NodoAST& nodo = arbol[raiz];
+    switch (nodo.tipo) {
+    case TipoNodo::IDENTIFICADOR:
+    case TipoNodo::ELEMENTO:
+    case TipoNodo::ASIGNACION:
+    case TipoNodo::PARA:
+    case TipoNodo::DECLARACION:
+    case TipoNodo::DIMENSION:
+    case TipoNodo::LLAMADA:
+        if (nodo.valor == nombre) return true;
+        break;
+    default:
+        break;
+    }
+    for (NodoId hijo : arbol.hijosDe(raiz)) {
+        if (usaNombre(arbol, hijo, nombre)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.h"
+
+using namespace std;
+
+// Análisis de los bucles Para para el generador.
+
+// Variable que el Para acumula: suma <- suma + expr (también - y expr + suma)
+// o prod <- prod * expr
+struct Reduccion {
+    string_view variable;
+    char operador; // '+' o '*'
+};
+
+// Listas de trabajo de estos análisis. Se reutilizan de un bucle al siguiente
+// (y entre compilaciones, en la memoria del generador de un Compilador).
+struct MemoriaParalelismo {
+    struct LecturaArreglo {
+        string_view arreglo;
+        NodoId indice;
+    };
+    vector<string_view> lecturas; // identificadores leídos fuera de una acumulación
+    vector<LecturaArreglo> lecturasArreglo;
+    vector<string_view> escritos; // arreglos con elementos asignados en el cuerpo
+    vector<string_view> modificadas;
+    vector<NodoId> pendientes;
+};
+
+// Decide si las iteraciones del Para `para` son independientes (--paralelizar).
+// `declaradas` son las variables ya declaradas antes del bucle: las demás que
+// se asignan dentro nacen en el cuerpo y cada iteración tiene la suya. Se
+// rechaza el bucle si:
+//  - lee o escribe (Leer/Escribir: el orden de la E/S cambiaría) o llama a
+//    un SubProceso (que podría hacerlo),
+//  - asigna la variable del Para o una variable de fuera que no es una
+//    reducción, o una reducción se lee fuera de su propia acumulación,
+//  - asigna un elemento de arreglo en otra posición que a[i] (i el contador)
+//    o lee un arreglo que se asigna en otra posición que a[i],
+//  - los límites dependen de algo que el cuerpo modifica,
+//  - la variable del Para no es entera o alguna reducción es una cadena.
+// Si es paralelizable deja en `reducciones` las variables acumuladas.
+bool analizarParalelismo(const ArbolAST& arbol, NodoId para, const ConjuntoSimbolos& declaradas,
+                         vector<Reduccion>& reducciones, MemoriaParalelismo& memoria);
+
+// El cuerpo del Para es una secuencia de asignaciones, sin control de flujo
+// (candidato a #pragma omp simd si además es paralelizable)
+bool cuerpoLineal(const ArbolAST& arbol, NodoId para);
+
+// Ni el contador ni nada de lo que el cuerpo modifica aparece en el Hasta, y
+// ni el Hasta ni el cuerpo tienen llamadas (pueden cambiar variables Por
+// Referencia): se puede evaluar una sola vez antes del bucle
+bool limiteInvariante(const ArbolAST& arbol, NodoId para, MemoriaParalelismo& memoria);
+
+// Algún nodo del subárbol de `raiz` usa o declara `nombre`
+bool usaNombre(const ArbolAST& arbol, NodoId raiz, string_view nombre);
+
+#endif
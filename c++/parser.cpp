@@ -1,187 +1,676 @@
 #include "parser.h"
+#include <algorithm>
+#include <cctype>
 #include <stdexcept>
+#include "types.h"
 
 using namespace std;
 
+namespace {
+
+bool igualSinMayusculas(string_view a, string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+// Se lanza al encontrar un error dentro de una sentencia (ya anotado): la
+// sentencia se descarta y el bucle de sentencias se resincroniza
+struct Recuperar {};
+
+string describir(const Token& token) {
+    return token.valor.empty() ? string("el final del programa") : "'" + string(token.valor) + "'";
+}
+
+string_view nombreCierre(PalabraClave clave) {
+    switch (clave) {
+        case PalabraClave::SINO: return "Sino";
+        case PalabraClave::FIN_SI: return "FinSi";
+        case PalabraClave::FIN_PARA: return "FinPara";
+        case PalabraClave::FIN_MIENTRAS: return "FinMientras";
+        case PalabraClave::FIN_SUBPROCESO: return "FinSubProceso";
+        case PalabraClave::FIN_FUNCION: return "FinFuncion";
+        default: return "FinAlgoritmo";
+    }
+}
+
+string mensajeErrores(const vector<Diagnostico>& diagnosticos, bool truncado) {
+    string mensaje;
+    for (const Diagnostico& diagnostico : diagnosticos) {
+        if (!mensaje.empty()) mensaje += '\n';
+        mensaje += "Error de sintaxis en la línea " + to_string(diagnostico.linea) + ": " + diagnostico.mensaje;
+    }
+    if (truncado) mensaje += "\n(se dejó de analizar tras " + to_string(diagnosticos.size()) + " errores)";
+    return mensaje;
+}
+
+} // namespace
+
+ErrorSintaxis::ErrorSintaxis(vector<Diagnostico> diagnosticos, bool truncado)
+    : runtime_error(mensajeErrores(diagnosticos, truncado)), lista(move(diagnosticos)) {}
+
 class Parser {
 public:
-    vector<Token> tokens;
-    size_t pos;
+    FlujoTokens& tokens;
+    ArbolAST& arbol;
+    vector<NodoId>& pila; // hijos pendientes de asignar a su nodo padre
+    TablaSimbolos propia; // si los tokens no traen tabla
+    TablaSimbolos& simbolos;
+    vector<PalabraClave>& abiertos; // cierres de los bloques en curso, del más externo al más interno
+    vector<Diagnostico> diagnosticos;
+    bool truncado = false;
+    size_t profundidad = 0;
+    
+    // Niveles de bloque o de expresión abiertos mientras vive
+    struct Nivel {
+        Parser& parser;
+        size_t niveles = 0;
+        explicit Nivel(Parser& p) : parser(p) { otro(); }
+        ~Nivel() { parser.profundidad -= niveles; }
+        void otro() {
+            if (parser.profundidad >= MAX_ANIDAMIENTO) {
+                parser.error("demasiados niveles anidados (máximo " + to_string(MAX_ANIDAMIENTO) + ")");
+            }
+            parser.profundidad++;
+            niveles++;
+        }
+    };
+    
+    Parser(FlujoTokens& t, ArbolAST& a, MemoriaParser& memoria)
+        : tokens(t), arbol(a), pila(memoria.pila), simbolos(t.tablaSimbolos() ? *t.tablaSimbolos() : propia),
+          abiertos(memoria.abiertos) {
+        pila.clear();
+        abiertos.clear();
+    }
+    
+    const Token& peek() { return tokens.peek(); }
+    Token consume() { return tokens.consume(); }
+    bool match(PalabraClave clave) { return peek().clave == clave; }
+    
+    // Palabras de la voz que no son reservadas: "inicio", "fin", "hacer" y
+    // "desde" solo cuentan si no son el nombre de una variable
+    bool esPalabra(string_view palabra) {
+        if (peek().tipo != IDENTIFICADOR || !igualSinMayusculas(peek().valor, palabra)) return false;
+        Operador siguiente = peek(1).op;
+        return siguiente != Operador::ASIGNACION && siguiente != Operador::IGUAL &&
+               siguiente != Operador::CORCHETE_ABRE && siguiente != Operador::PARENTESIS_ABRE;
+    }
+    
+    int lineaActual() { return tokens.fin() ? tokens.ultimoConsumido().linea : peek().linea; }
+    
+    void anotar(int linea, string mensaje) {
+        if (diagnosticos.size() < MAX_DIAGNOSTICOS) {
+            diagnosticos.push_back({linea, move(mensaje)});
+        } else {
+            truncado = true;
+        }
+    }
+    
+    [[noreturn]] void error(const string& mensaje) {
+        anotar(lineaActual(), mensaje);
+        throw Recuperar{};
+    }
+    
+    void terminar() {
+        if (!diagnosticos.empty()) throw ErrorSintaxis(move(diagnosticos), truncado);
+    }
+    
+    // Cierre de bloque en la posición actual, o NINGUNA. FinProceso y "fin"
+    // solo (voz) cierran el algoritmo; "fin si", "fin para"... en la misma
+    // línea equivalen a FinSi, FinPara...
+    PalabraClave cierre() {
+        const Token& token = peek();
+        switch (token.clave) {
+            case PalabraClave::SINO:
+            case PalabraClave::FIN_SI:
+            case PalabraClave::FIN_PARA:
+            case PalabraClave::FIN_MIENTRAS:
+            case PalabraClave::FIN_SUBPROCESO:
+            case PalabraClave::FIN_FUNCION:
+            case PalabraClave::FIN_ALGORITMO:
+                return token.clave;
+            case PalabraClave::FIN_PROCESO:
+                return PalabraClave::FIN_ALGORITMO;
+            default:
+                break;
+        }
+        if (!esPalabra("fin")) return PalabraClave::NINGUNA;
+        if (peek(1).linea == token.linea) {
+            switch (peek(1).clave) {
+                case PalabraClave::SI: return PalabraClave::FIN_SI;
+                case PalabraClave::PARA: return PalabraClave::FIN_PARA;
+                case PalabraClave::MIENTRAS: return PalabraClave::FIN_MIENTRAS;
+                case PalabraClave::SUBPROCESO: return PalabraClave::FIN_SUBPROCESO;
+                case PalabraClave::FUNCION: return PalabraClave::FIN_FUNCION;
+                default: break;
+            }
+        }
+        return PalabraClave::FIN_ALGORITMO;
+    }
+    
+    void consumirCierre() {
+        Token token = consume();
+        if (token.tipo == IDENTIFICADOR && peek().linea == token.linea &&
+            (match(PalabraClave::SI) || match(PalabraClave::PARA) || match(PalabraClave::MIENTRAS) ||
+             match(PalabraClave::SUBPROCESO) || match(PalabraClave::FUNCION))) {
+            consume(); // "fin si", "fin para"...
+        }
+    }
     
-    Parser(const vector<Token>& t) : tokens(t), pos(0) {}
+    bool estaAbierto(PalabraClave clave) {
+        return find(abiertos.begin(), abiertos.end(), clave) != abiertos.end();
+    }
+    
+    // Consume el cierre del bloque abierto en la línea `linea`; si falta, lo anota
+    void cerrar(PalabraClave clave, string_view abre, int linea) {
+        if (cierre() == clave) {
+            consumirCierre();
+        } else {
+            anotar(lineaActual(), "falta " + string(nombreCierre(clave)) + " (el " + string(abre) +
+                                      " empieza en la línea " + to_string(linea) + ")");
+        }
+    }
+    
+    // Palabras donde puede empezar una sentencia tras un error
+    bool iniciaSentencia() {
+        switch (peek().clave) {
+            case PalabraClave::ESCRIBIR:
+            case PalabraClave::LEER:
+            case PalabraClave::SI:
+            case PalabraClave::PARA:
+            case PalabraClave::MIENTRAS:
+            case PalabraClave::SUBPROCESO:
+            case PalabraClave::FUNCION:
+                return true;
+            default:
+                return cierre() != PalabraClave::NINGUNA;
+        }
+    }
+    
+    // Ejecuta `analizar` (una sentencia o un SubProceso); si falla, descarta
+    // lo que dejó en la pila y salta hasta la siguiente sentencia o línea,
+    // consumiendo al menos un token para avanzar siempre.
+    template <typename Analizar>
+    NodoId recuperando(Analizar analizar) {
+        size_t marca = pila.size();
+        const char* inicio = peek().valor.data();
+        try {
+            return analizar();
+        } catch (const Recuperar&) {
+            pila.resize(marca);
+            if (!tokens.fin() && peek().valor.data() == inicio) consume();
+            int linea = tokens.ultimoConsumido().linea;
+            while (!tokens.fin() && peek().linea == linea && !iniciaSentencia()) consume();
+            return NODO_NULO;
+        }
+    }
     
-    Token peek() { return pos < tokens.size() ? tokens[pos] : Token{DESCONOCIDO, "", 0}; }
-    Token consume() { return pos < tokens.size() ? tokens[pos++] : Token{DESCONOCIDO, "", 0}; }
-    bool match(const string& valor) { return peek().valor == valor; }
+    // Sentencias hasta el cierre de un bloque abierto (este o uno que lo
+    // contiene, que lo consumirá) o el final.
+    void parseSentencias() {
+        while (!tokens.fin() && !truncado) {
+            PalabraClave clave = cierre();
+            if (clave != PalabraClave::NINGUNA && estaAbierto(clave)) break;
+            NodoId stmt = recuperando([this] { return parseStatement(); });
+            if (stmt != NODO_NULO) pila.push_back(stmt);
+        }
+    }
     
-    NodoAST* parsePrograma() {
-        NodoAST* programa = new NodoAST{"PROGRAMA", ""};
+    // SubProcesos antes y después del algoritmo, en el orden en que aparecen
+    NodoId parsePrograma() {
+        size_t marca = pila.size();
         
-        if (match("Algoritmo")) {
-            programa->hijos.push_back(parseAlgoritmo());
+        parseFunciones();
+        if (match(PalabraClave::ALGORITMO) || match(PalabraClave::PROCESO)) {
+            pila.push_back(parseAlgoritmo());
+            parseFunciones();
+        } else if (!tokens.fin() && !truncado) {
+            anotar(lineaActual(), "se esperaba Algoritmo <nombre> y se encontró " + describir(peek()));
         }
         
-        return programa;
+        return arbol.crearNodo(TipoNodo::PROGRAMA, "", pila, marca);
     }
     
-    NodoAST* parseAlgoritmo() {
-        consume(); // "Algoritmo"
-        Token nombre = consume();
+    void parseFunciones() {
+        while ((match(PalabraClave::SUBPROCESO) || match(PalabraClave::FUNCION)) && !truncado) {
+            NodoId funcion = recuperando([this] { return parseFuncion(); });
+            if (funcion != NODO_NULO) pila.push_back(funcion);
+        }
+    }
+    
+    // SubProceso [<retorno> <-] <nombre>[(<parámetro> [Por Valor|Por Referencia], ...)]
+    //     ...
+    // FinSubProceso (o Funcion ... FinFuncion)
+    NodoId parseFuncion() {
+        int linea = consume().linea; // "SubProceso" o "Funcion"
+        Token nombre = consumirNombre("del SubProceso");
+        NodoId retorno = NODO_NULO;
+        if (peek().op == Operador::ASIGNACION || peek().op == Operador::IGUAL) {
+            consume();
+            retorno = arbol.crearHoja(TipoNodo::IDENTIFICADOR, nombre.valor, simboloDe(nombre));
+            nombre = consumirNombre("del SubProceso");
+        }
         
-        NodoAST* algoritmo = new NodoAST{"ALGORITMO", nombre.valor};
+        size_t marca = pila.size();
+        if (peek().op == Operador::PARENTESIS_ABRE) {
+            consume();
+            while (peek().tipo == IDENTIFICADOR) {
+                pila.push_back(parseParametro());
+                if (peek().op != Operador::COMA) break;
+                consume();
+            }
+            if (peek().op == Operador::PARENTESIS_CIERRA) consume();
+        }
+        pila.push_back(arbol.crearNodo(TipoNodo::BLOQUE, "", pila, marca));
         
-        while (!match("FinAlgoritmo") && pos < tokens.size()) {
-            algoritmo->hijos.push_back(parseStatement());
+        pila.push_back(parseBloque(PalabraClave::FIN_SUBPROCESO, PalabraClave::FIN_FUNCION));
+        if (cierre() == PalabraClave::FIN_SUBPROCESO || cierre() == PalabraClave::FIN_FUNCION) {
+            consumirCierre();
+        } else {
+            cerrar(PalabraClave::FIN_SUBPROCESO, "SubProceso", linea);
+        }
+        if (retorno != NODO_NULO) pila.push_back(retorno);
+        return nombrar(arbol.crearNodo(TipoNodo::FUNCION, nombre.valor, pila, marca), nombre);
+    }
+    
+    NodoId parseParametro() {
+        Token nombre = consume();
+        size_t marca = pila.size();
+        if (igualSinMayusculas(peek().valor, "por") && peek(1).tipo == IDENTIFICADOR) {
+            consume();
+            Token modo = consume();
+            if (igualSinMayusculas(modo.valor, "referencia")) {
+                pila.push_back(arbol.crearHoja(TipoNodo::EXPRESION, modo.valor));
+            }
+        }
+        return nombrar(arbol.crearNodo(TipoNodo::PARAMETRO, nombre.valor, pila, marca), nombre);
+    }
+    
+    // Sin FinAlgoritmo el algoritmo termina al final del programa
+    NodoId parseAlgoritmo() {
+        consume(); // "Algoritmo" o "Proceso"
+        string_view nombre;
+        if (peek().tipo == IDENTIFICADOR) {
+            nombre = consume().valor;
+        } else {
+            anotar(lineaActual(), "falta el nombre del algoritmo");
         }
         
-        if (match("FinAlgoritmo")) consume();
+        size_t marca = pila.size();
+        abiertos.push_back(PalabraClave::FIN_ALGORITMO);
+        parseSentencias();
+        abiertos.pop_back();
         
-        return algoritmo;
+        if (cierre() == PalabraClave::FIN_ALGORITMO) consumirCierre();
+        
+        return arbol.crearNodo(TipoNodo::ALGORITMO, nombre, pila, marca);
     }
     
-    NodoAST* parseStatement() {
-        if (match("Escribir")) return parseEscribir();
-        if (match("Leer")) return parseLeer();
-        if (match("Si")) return parseSi();
-        if (match("Para")) return parsePara();
-        if (match("Mientras")) return parseMientras();
-        if (peek().tipo == IDENTIFICADOR) return parseAsignacion();
+    NodoId parseStatement() {
+        if (match(PalabraClave::ESCRIBIR)) return parseEscribir();
+        if (match(PalabraClave::LEER)) return parseLeer();
+        if (match(PalabraClave::SI)) return parseSi();
+        if (match(PalabraClave::PARA)) return parsePara();
+        if (match(PalabraClave::MIENTRAS)) return parseMientras();
+        if (peek().tipo == IDENTIFICADOR) {
+            if (esSeccionVar()) return parseSeccionVar();
+            if (esDefinir()) return parseDefinir();
+            if (esDimension()) return parseDimension();
+            if (peek(1).op == Operador::PARENTESIS_ABRE) return parseLlamada();
+            if (cierre() != PalabraClave::NINGUNA) error(describir(peek()) + " no cierra ningún bloque abierto");
+            // "inicio" tras la cabecera (voz); sin "var" delante no hace nada
+            if (esPalabra("inicio")) {
+                consume();
+                return NODO_NULO;
+            }
+            return parseAsignacion();
+        }
         
-        // Skip unknown tokens
-        consume();
-        return nullptr;
+        if (cierre() != PalabraClave::NINGUNA) error(describir(peek()) + " no cierra ningún bloque abierto");
+        error("se esperaba una sentencia y se encontró " + describir(peek()));
+    }
+    
+    Token consumirNombre(const char* deQue) {
+        if (peek().tipo != IDENTIFICADOR) error("se esperaba el nombre " + string(deQue) + " y se encontró " + describir(peek()));
+        return consume();
     }
     
-    NodoAST* parseEscribir() {
+    // "var" y "Definir ... Como" no son palabras reservadas (pueden ser nombres
+    // de variable): se reconocen por lo que les sigue.
+    bool esSeccionVar() {
+        return igualSinMayusculas(peek().valor, "var") && peek(1).tipo == IDENTIFICADOR &&
+               tipoDeNombre(peek(2).valor) != TipoDato::DESCONOCIDO;
+    }
+    
+    bool esDefinir() {
+        return igualSinMayusculas(peek().valor, "definir") && peek(1).tipo == IDENTIFICADOR &&
+               peek(2).op != Operador::ASIGNACION && peek(2).op != Operador::IGUAL;
+    }
+    
+    bool esDimension() {
+        return igualSinMayusculas(peek().valor, "dimension") && peek(1).tipo == IDENTIFICADOR &&
+               peek(2).op == Operador::CORCHETE_ABRE;
+    }
+    
+    const Token& peek(size_t k) { return tokens.peek(k); }
+    
+    // Los tokens de un flujo sin tabla no traen id: se internan aquí
+    SimboloId simboloDe(const Token& token) {
+        return token.simbolo != SIN_SIMBOLO ? token.simbolo : simbolos.internar(token.valor);
+    }
+    
+    NodoId nombrar(NodoId id, const Token& nombre) {
+        arbol.nodos[id].simbolo = simboloDe(nombre);
+        return id;
+    }
+    
+    // [expresión]; el corchete de apertura ya está consumido
+    NodoId parseIndice() {
+        NodoId indice = parseExpresion();
+        if (peek().op == Operador::CORCHETE_CIERRA) consume();
+        return indice;
+    }
+    
+    NodoId crearDeclaracion(const Token& nombre, TipoDato tipo) {
+        NodoId id = arbol.crearHoja(TipoNodo::DECLARACION, nombre.valor, simboloDe(nombre));
+        arbol.nodos[id].tipoDato = tipo;
+        return id;
+    }
+    
+    // var <nombre> <tipo> ... [inicio], como lo escribe la transcripción de voz
+    NodoId parseSeccionVar() {
+        consume(); // "var"
+        size_t marca = pila.size();
+        while (peek().tipo == IDENTIFICADOR && peek(1).tipo == IDENTIFICADOR) {
+            TipoDato tipo = tipoDeNombre(peek(1).valor);
+            if (tipo == TipoDato::DESCONOCIDO) break;
+            Token nombre = consume();
+            consume(); // tipo
+            pila.push_back(crearDeclaracion(nombre, tipo));
+        }
+        if (igualSinMayusculas(peek().valor, "inicio")) consume();
+        return arbol.crearNodo(TipoNodo::BLOQUE, "", pila, marca);
+    }
+    
+    // Definir <nombre>[, <nombre>...] Como <tipo>
+    NodoId parseDefinir() {
+        consume(); // "Definir"
+        size_t marca = pila.size();
+        while (peek().tipo == IDENTIFICADOR) {
+            pila.push_back(crearDeclaracion(consume(), TipoDato::DESCONOCIDO));
+            if (peek().op != Operador::COMA) break;
+            consume();
+        }
+        if (igualSinMayusculas(peek().valor, "como")) {
+            consume();
+            TipoDato tipo = tipoDeNombre(consume().valor);
+            for (size_t i = marca; i < pila.size(); i++) {
+                arbol.nodos[pila[i]].tipoDato = tipo;
+            }
+        }
+        return arbol.crearNodo(TipoNodo::BLOQUE, "", pila, marca);
+    }
+    
+    // Dimension <nombre>[<tamaño>][, <nombre>[<tamaño>]...]
+    NodoId parseDimension() {
+        consume(); // "Dimension"
+        size_t marca = pila.size();
+        while (peek().tipo == IDENTIFICADOR && peek(1).op == Operador::CORCHETE_ABRE) {
+            Token nombre = consume();
+            consume(); // "["
+            size_t marcaTamano = pila.size();
+            pila.push_back(parseIndice());
+            pila.push_back(nombrar(arbol.crearNodo(TipoNodo::DIMENSION, nombre.valor, pila, marcaTamano), nombre));
+            if (peek().op != Operador::COMA) break;
+            consume();
+        }
+        return arbol.crearNodo(TipoNodo::BLOQUE, "", pila, marca);
+    }
+    
+    NodoId parseEscribir() {
         consume(); // "Escribir"
-        NodoAST* escribir = new NodoAST{"ESCRIBIR", ""};
-        escribir->hijos.push_back(parseExpresion());
-        return escribir;
+        size_t marca = pila.size();
+        pila.push_back(parseExpresion());
+        return arbol.crearNodo(TipoNodo::ESCRIBIR, "", pila, marca);
     }
     
-    NodoAST* parseLeer() {
+    // Leer x, Leer a[i] o, en la voz, leer(x)
+    NodoId parseLeer() {
         consume(); // "Leer"
-        NodoAST* leer = new NodoAST{"LEER", ""};
-        Token var = consume();
-        leer->hijos.push_back(new NodoAST{"IDENTIFICADOR", var.valor});
-        return leer;
+        bool parentesis = peek().op == Operador::PARENTESIS_ABRE;
+        if (parentesis) consume();
+        if (peek().tipo != IDENTIFICADOR) error("se esperaba una variable después de Leer y se encontró " + describir(peek()));
+        size_t marca = pila.size();
+        pila.push_back(parseVariable());
+        if (parentesis && peek().op == Operador::PARENTESIS_CIERRA) consume();
+        return arbol.crearNodo(TipoNodo::LEER, "", pila, marca);
+    }
+    
+    // Parsea sentencias hasta encontrar alguna de las palabras de cierre (o la
+    // de un bloque que lo contiene: entonces el que llama anota que falta la suya).
+    NodoId parseBloque(PalabraClave fin1, PalabraClave fin2 = PalabraClave::NINGUNA) {
+        Nivel anidado(*this);
+        size_t marca = pila.size();
+        size_t abiertosAntes = abiertos.size();
+        abiertos.push_back(fin1);
+        if (fin2 != PalabraClave::NINGUNA) abiertos.push_back(fin2);
+        parseSentencias();
+        abiertos.resize(abiertosAntes);
+        return arbol.crearNodo(TipoNodo::BLOQUE, "", pila, marca);
     }
     
-    NodoAST* parseSi() {
-        consume(); // "Si"
-        NodoAST* si = new NodoAST{"SI", ""};
-        si->hijos.push_back(parseExpresion()); // condición
+    NodoId parseSi() {
+        int linea = consume().linea; // "Si"
+        size_t marca = pila.size();
+        pila.push_back(parseExpresion()); // condición
         
-        if (match("Entonces")) consume();
+        if (match(PalabraClave::ENTONCES)) consume();
         
-        NodoAST* bloqueThen = new NodoAST{"BLOQUE", ""};
-        while (!match("Sino") && !match("FinSi") && pos < tokens.size()) {
-            NodoAST* stmt = parseStatement();
-            if (stmt) bloqueThen->hijos.push_back(stmt);
-        }
-        si->hijos.push_back(bloqueThen);
+        pila.push_back(parseBloque(PalabraClave::SINO, PalabraClave::FIN_SI)); // bloque then
         
-        if (match("Sino")) {
+        if (cierre() == PalabraClave::SINO) {
             consume();
-            NodoAST* bloqueElse = new NodoAST{"BLOQUE", ""};
-            while (!match("FinSi") && pos < tokens.size()) {
-                NodoAST* stmt = parseStatement();
-                if (stmt) bloqueElse->hijos.push_back(stmt);
-            }
-            si->hijos.push_back(bloqueElse);
+            pila.push_back(parseBloque(PalabraClave::FIN_SI)); // bloque else
         }
         
-        if (match("FinSi")) consume();
-        return si;
+        cerrar(PalabraClave::FIN_SI, "Si", linea);
+        return arbol.crearNodo(TipoNodo::SI, "", pila, marca);
     }
     
-    NodoAST* parsePara() {
-        consume(); // "Para"
-        Token var = consume();
-        consume(); // "<-" or "="
-        
-        NodoAST* para = new NodoAST{"PARA", var.valor};
-        para->hijos.push_back(parseExpresion()); // inicio
-        
-        if (match("Hasta")) {
+    // Para i <- a Hasta b [Hacer]; la voz también dice "para i desde a hasta b hacer"
+    NodoId parsePara() {
+        int linea = consume().linea; // "Para"
+        Token var = consumirNombre("de la variable del Para");
+        if (peek().op == Operador::ASIGNACION || peek().op == Operador::IGUAL || esPalabra("desde")) {
             consume();
-            para->hijos.push_back(parseExpresion()); // fin
+        } else {
+            error("se esperaba '<-' después de la variable del Para y se encontró " + describir(peek()));
         }
         
-        NodoAST* bloque = new NodoAST{"BLOQUE", ""};
-        while (!match("FinPara") && pos < tokens.size()) {
-            NodoAST* stmt = parseStatement();
-            if (stmt) bloque->hijos.push_back(stmt);
-        }
-        para->hijos.push_back(bloque);
+        size_t marca = pila.size();
+        pila.push_back(parseExpresion()); // inicio
+        
+        if (!match(PalabraClave::HASTA)) error("se esperaba Hasta en el Para y se encontró " + describir(peek()));
+        consume();
+        pila.push_back(parseExpresion()); // fin
+        if (esPalabra("hacer")) consume();
+        
+        pila.push_back(parseBloque(PalabraClave::FIN_PARA));
         
-        if (match("FinPara")) consume();
-        return para;
+        cerrar(PalabraClave::FIN_PARA, "Para", linea);
+        return nombrar(arbol.crearNodo(TipoNodo::PARA, var.valor, pila, marca), var);
     }
     
-    NodoAST* parseMientras() {
-        consume(); // "Mientras"
-        NodoAST* mientras = new NodoAST{"MIENTRAS", ""};
-        mientras->hijos.push_back(parseExpresion()); // condición
+    NodoId parseMientras() {
+        int linea = consume().linea; // "Mientras"
+        size_t marca = pila.size();
+        pila.push_back(parseExpresion()); // condición
+        if (esPalabra("hacer")) consume();
         
-        NodoAST* bloque = new NodoAST{"BLOQUE", ""};
-        while (!match("FinMientras") && pos < tokens.size()) {
-            NodoAST* stmt = parseStatement();
-            if (stmt) bloque->hijos.push_back(stmt);
-        }
-        mientras->hijos.push_back(bloque);
+        pila.push_back(parseBloque(PalabraClave::FIN_MIENTRAS));
         
-        if (match("FinMientras")) consume();
-        return mientras;
+        cerrar(PalabraClave::FIN_MIENTRAS, "Mientras", linea);
+        return arbol.crearNodo(TipoNodo::MIENTRAS, "", pila, marca);
     }
     
-    NodoAST* parseAsignacion() {
+    // a <- expr: hijos = [expr]; a[i] <- expr: hijos = [expr, índice]
+    NodoId parseAsignacion() {
         Token var = consume();
-        consume(); // "<-" or "="
+        NodoId indice = NODO_NULO;
+        if (peek().op == Operador::CORCHETE_ABRE) {
+            consume();
+            indice = parseIndice();
+        }
+        if (peek().op != Operador::ASIGNACION && peek().op != Operador::IGUAL) {
+            error("se esperaba '<-' después de '" + string(var.valor) + "' y se encontró " + describir(peek()));
+        }
+        consume();
         
-        NodoAST* asignacion = new NodoAST{"ASIGNACION", var.valor};
-        asignacion->hijos.push_back(parseExpresion());
-        return asignacion;
+        size_t marca = pila.size();
+        pila.push_back(parseExpresion());
+        if (indice != NODO_NULO) pila.push_back(indice);
+        return nombrar(arbol.crearNodo(TipoNodo::ASIGNACION, var.valor, pila, marca), var);
     }
     
-    NodoAST* parseExpresion() {
-        NodoAST* left = parseTerm();
+    // Identificador o elemento de un arreglo
+    NodoId parseVariable() {
+        Token var = consume();
+        if (peek().op != Operador::CORCHETE_ABRE) {
+            return arbol.crearHoja(TipoNodo::IDENTIFICADOR, var.valor, simboloDe(var));
+        }
+        consume();
+        size_t marca = pila.size();
+        pila.push_back(parseIndice());
+        return nombrar(arbol.crearNodo(TipoNodo::ELEMENTO, var.valor, pila, marca), var);
+    }
+    
+    // nombre(argumentos), como sentencia o dentro de una expresión
+    NodoId parseLlamada() {
+        Token nombre = consume();
+        consume(); // "("
+        size_t marca = pila.size();
+        while (peek().op != Operador::PARENTESIS_CIERRA && !tokens.fin()) {
+            pila.push_back(parseExpresion());
+            if (peek().op != Operador::COMA) break;
+            consume();
+        }
+        if (peek().op == Operador::PARENTESIS_CIERRA) consume();
+        return nombrar(arbol.crearNodo(TipoNodo::LLAMADA, nombre.valor, pila, marca), nombre);
+    }
+    
+    // Precedence climbing: cada nivel de OPERADORES se resuelve en una sola
+    // pasada, agrupando a la izquierda los operadores de igual precedencia.
+    NodoId parseExpresion(uint8_t precedenciaMinima = 1) {
+        Nivel anidado(*this);
+        NodoId left = parseTerm();
         
-        while (pos < tokens.size() && (peek().valor == "+" || peek().valor == "-" || 
-               peek().valor == ">" || peek().valor == "<" || peek().valor == "<=" || 
-               peek().valor == ">=" || peek().valor == "==" || peek().valor == "!=")) {
-            Token op = consume();
-            NodoAST* right = parseTerm();
+        for (;;) {
+            Operador op = peek().op;
+            uint8_t nivel = precedencia(op);
+            if (nivel == 0 || nivel < precedenciaMinima) break;
             
-            NodoAST* binOp = new NodoAST{"OPERACION_BINARIA", op.valor};
-            binOp->hijos.push_back(left);
-            binOp->hijos.push_back(right);
-            left = binOp;
+            // Cada operación deja el árbol un nivel más hondo por la izquierda
+            anidado.otro();
+            string_view texto = consume().valor;
+            size_t marca = pila.size();
+            pila.push_back(left);
+            pila.push_back(parseExpresion(nivel + 1));
+            left = arbol.crearNodo(TipoNodo::OPERACION_BINARIA, texto, pila, marca, op);
         }
         
         return left;
     }
     
-    NodoAST* parseTerm() {
+    NodoId parseTerm() {
+        if (peek().tipo == IDENTIFICADOR) {
+            return peek(1).op == Operador::PARENTESIS_ABRE ? parseLlamada() : parseVariable();
+        }
+        // -3: un solo número negativo
+        if (peek().op == Operador::RESTA && peek(1).tipo == NUMERO) {
+            consume();
+            return arbol.crearHoja(TipoNodo::NUMERO, arbol.guardarTexto("-" + string(consume().valor)));
+        }
+        const Token& siguiente = peek();
+        if (siguiente.tipo != NUMERO && siguiente.tipo != CADENA && siguiente.op != Operador::PARENTESIS_ABRE &&
+            !match(PalabraClave::VERDADERO) && !match(PalabraClave::FALSO)) {
+            error("se esperaba una expresión y se encontró " + describir(siguiente));
+        }
         Token token = consume();
         
         if (token.tipo == NUMERO) {
-            return new NodoAST{"NUMERO", token.valor};
+            return arbol.crearHoja(TipoNodo::NUMERO, token.valor);
         } else if (token.tipo == CADENA) {
-            return new NodoAST{"CADENA", token.valor};
-        } else if (token.tipo == IDENTIFICADOR) {
-            return new NodoAST{"IDENTIFICADOR", token.valor};
+            return arbol.crearHoja(TipoNodo::CADENA, token.valor);
+        } else if (token.op == Operador::PARENTESIS_ABRE) {
+            NodoId interior = parseExpresion();
+            if (peek().op == Operador::PARENTESIS_CIERRA) consume();
+            return interior;
         }
         
-        return new NodoAST{"EXPRESION", token.valor};
+        return arbol.crearHoja(TipoNodo::EXPRESION, token.valor);
     }
 };
 
-NodoAST* analizarSintaxis(const vector<Token>& tokens) {
+void analizarSintaxis(FlujoTokens& tokens, ArbolAST& arbol) {
+    MemoriaParser memoria;
+    analizarSintaxis(tokens, arbol, memoria);
+}
+
+void analizarSintaxis(FlujoTokens& tokens, ArbolAST& arbol, MemoriaParser& memoria) {
+    arbol.limpiar();
     try {
-        Parser parser(tokens);
-        return parser.parsePrograma();
+        Parser parser(tokens, arbol, memoria);
+        arbol.raiz = parser.parsePrograma();
+        parser.terminar();
+    } catch (const ErrorSintaxis&) {
+        throw;
     } catch (const exception& e) {
         throw runtime_error(string("Error de sintaxis: ") + e.what());
     }
+}
+
+ArbolAST analizarSintaxis(FlujoTokens& tokens) {
+    ArbolAST arbol;
+    analizarSintaxis(tokens, arbol);
+    return arbol;
+}
+
+bool analizarCabecera(FlujoTokens& tokens, string_view& nombre) {
+    PalabraClave clave = tokens.peek().clave;
+    if ((clave != PalabraClave::ALGORITMO && clave != PalabraClave::PROCESO) || tokens.peek(1).tipo != IDENTIFICADOR) {
+        return false;
+    }
+    tokens.consume(); // "Algoritmo" o "Proceso"
+    nombre = tokens.consume().valor;
+    return true;
+}
+
+bool analizarSentencia(FlujoTokens& tokens, ArbolAST& arbol) {
+    arbol.limpiar();
+    MemoriaParser memoria;
+    try {
+        Parser parser(tokens, arbol, memoria);
+        // Como dentro de parseAlgoritmo
+        parser.abiertos.push_back(PalabraClave::FIN_ALGORITMO);
+        if (tokens.fin() || parser.cierre() == PalabraClave::FIN_ALGORITMO) return false;
+        arbol.raiz = parser.recuperando([&parser] { return parser.parseStatement(); });
+        parser.terminar();
+    } catch (const ErrorSintaxis&) {
+        throw;
+    } catch (const exception& e) {
+        throw runtime_error(string("Error de sintaxis: ") + e.what());
+    }
+    return true;
+}
+
+ArbolAST analizarSintaxis(Lexer& lexer) {
+    FlujoTokens flujo(lexer);
+    return analizarSintaxis(flujo);
+}
+
+ArbolAST analizarSintaxis(const vector<Token>& tokens) {
+    FlujoTokens flujo(tokens);
+    return analizarSintaxis(flujo);
 }
\ No newline at end of file
@@ -2,20 +2,62 @@
 #define PARSER_H
 
 #include "lexer.h"
+#include "ast.h"
+#include <stdexcept>
+#include <string>
 #include <vector>
 
-struct NodoAST {
-    string tipo;
-    string valor;
-    vector<NodoAST*> hijos;
+// Errores de sintaxis: el parser anota cada error, descarta la sentencia y
+// sigue en la siguiente sentencia o línea, así un programa mal transcrito se
+// analiza en tiempo lineal y se informa de todo a la vez. Al terminar, si hubo
+// alguno, lanza ErrorSintaxis con los primeros MAX_DIAGNOSTICOS.
+const size_t MAX_DIAGNOSTICOS = 20;
 
-    ~NodoAST() {
-        for (auto hijo : hijos) {
-            delete hijo;
-        }
-    }
+// Bloques y expresiones más anidados que esto son un error (el análisis y la
+// generación son recursivos: que no desborden la pila del hilo)
+const size_t MAX_ANIDAMIENTO = 500;
+
+struct Diagnostico {
+    int linea;
+    string mensaje;
+};
+
+class ErrorSintaxis : public runtime_error {
+public:
+    // `truncado`: se dejó de analizar al llenarse la lista
+    ErrorSintaxis(vector<Diagnostico> diagnosticos, bool truncado);
+    const vector<Diagnostico>& diagnosticos() const { return lista; }
+
+private:
+    vector<Diagnostico> lista;
 };
 
-NodoAST* analizarSintaxis(const vector<Token>& tokens);
+// Pilas de trabajo del parser. Un Compilador conserva la suya entre
+// compilaciones para no volver a reservarlas.
+struct MemoriaParser {
+    vector<NodoId> pila;
+    vector<PalabraClave> abiertos;
+};
+
+// Los valores del árbol apuntan al mismo texto que los tokens (el código
+// fuente), que debe seguir vivo mientras se use el árbol.
+ArbolAST analizarSintaxis(FlujoTokens& tokens);
+// Reutiliza la memoria de `arbol` (se limpia antes de parsear)
+void analizarSintaxis(FlujoTokens& tokens, ArbolAST& arbol);
+void analizarSintaxis(FlujoTokens& tokens, ArbolAST& arbol, MemoriaParser& memoria);
+// Consume los tokens a medida que el lexer los produce
+ArbolAST analizarSintaxis(Lexer& lexer);
+ArbolAST analizarSintaxis(const vector<Token>& tokens);
+
+// Parseo por partes para la compilación incremental. Aplicadas en orden
+// reconocen lo mismo que analizarSintaxis (y lanzan ErrorSintaxis igual,
+// aunque solo con los errores de una sentencia).
+// Consume "Algoritmo <nombre>" (o "Proceso <nombre>"); false (sin consumir)
+// si el programa no empieza así.
+bool analizarCabecera(FlujoTokens& tokens, string_view& nombre);
+// Parsea en `arbol` la siguiente sentencia del algoritmo (raiz = NODO_NULO si
+// no genera nada, como el "inicio" de la voz). false al llegar a FinAlgoritmo
+// (o "fin") o al final.
+bool analizarSentencia(FlujoTokens& tokens, ArbolAST& arbol);
 
 #endif
\ No newline at end of file
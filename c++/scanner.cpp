@@ -0,0 +1,149 @@
+#include "scanner.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ESCANER_SIMD "AVX2"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ESCANER_SIMD "SSE2"
+#endif
+
+namespace {
+
+#if defined(__AVX2__)
+
+// 32 bytes por iteración; cada método devuelve una máscara de un bit por byte.
+struct Bloque {
+    static constexpr size_t ANCHO = 32;
+    static constexpr uint32_t COMPLETA = 0xFFFFFFFFu;
+    __m256i v;
+
+    static Bloque cargar(const char* p) { return {_mm256_loadu_si256((const __m256i*)p)}; }
+
+    uint32_t igual(char c) const {
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+    }
+
+    // lo <= byte <= lo + ancho (comparación sin signo)
+    uint32_t enRango(char lo, uint8_t ancho, uint8_t orMascara = 0) const {
+        __m256i x = _mm256_or_si256(v, _mm256_set1_epi8((char)orMascara));
+        __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+        __m256i dentro = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8((char)ancho)), t);
+        return (uint32_t)_mm256_movemask_epi8(dentro);
+    }
+};
+
+#elif defined(__SSE2__)
+
+// 16 bytes por iteración; cada método devuelve una máscara de un bit por byte.
+struct Bloque {
+    static constexpr size_t ANCHO = 16;
+    static constexpr uint32_t COMPLETA = 0xFFFFu;
+    __m128i v;
+
+    static Bloque cargar(const char* p) { return {_mm_loadu_si128((const __m128i*)p)}; }
+
+    uint32_t igual(char c) const {
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+    }
+
+    // lo <= byte <= lo + ancho (comparación sin signo)
+    uint32_t enRango(char lo, uint8_t ancho, uint8_t orMascara = 0) const {
+        __m128i x = _mm_or_si128(v, _mm_set1_epi8((char)orMascara));
+        __m128i t = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+        __m128i dentro = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8((char)ancho)), t);
+        return (uint32_t)_mm_movemask_epi8(dentro);
+    }
+};
+
+#endif
+
+#ifdef ESCANER_SIMD
+
+inline uint32_t espacios(const Bloque& b) {
+    return b.igual(' ') | b.enRango('\t', '\r' - '\t');
+}
+
+inline uint32_t identificador(const Bloque& b) {
+    return b.enRango('a', 'z' - 'a', 0x20) | b.enRango('0', 9) | b.igual('_');
+}
+
+#endif
+
+} // namespace
+
+size_t saltarEspacios(const char* s, size_t i, size_t n, int& linea) {
+#ifdef ESCANER_SIMD
+    while (i + Bloque::ANCHO <= n) {
+        Bloque b = Bloque::cargar(s + i);
+        uint32_t saltos = b.igual('\n');
+        uint32_t resto = ~espacios(b) & Bloque::COMPLETA;
+        if (resto) {
+            uint32_t k = __builtin_ctz(resto);
+            linea += __builtin_popcount(saltos & ((1u << k) - 1));
+            return i + k;
+        }
+        linea += __builtin_popcount(saltos);
+        i += Bloque::ANCHO;
+    }
+#endif
+    while (i < n && esClase(s[i], CLASE_ESPACIO)) {
+        if (s[i] == '\n') linea++;
+        i++;
+    }
+    return i;
+}
+
+size_t finIdentificador(const char* s, size_t i, size_t n) {
+#ifdef ESCANER_SIMD
+    while (i + Bloque::ANCHO <= n) {
+        uint32_t resto = ~identificador(Bloque::cargar(s + i)) & Bloque::COMPLETA;
+        if (resto) return i + __builtin_ctz(resto);
+        i += Bloque::ANCHO;
+    }
+#endif
+    while (i < n && esClase(s[i], CLASE_IDENTIFICADOR)) i++;
+    return i;
+}
+
+size_t finDigitos(const char* s, size_t i, size_t n) {
+#ifdef ESCANER_SIMD
+    while (i + Bloque::ANCHO <= n) {
+        uint32_t resto = ~Bloque::cargar(s + i).enRango('0', 9) & Bloque::COMPLETA;
+        if (resto) return i + __builtin_ctz(resto);
+        i += Bloque::ANCHO;
+    }
+#endif
+    while (i < n && esClase(s[i], CLASE_DIGITO)) i++;
+    return i;
+}
+
+size_t buscarCaracter(const char* s, size_t i, size_t n, char c) {
+    // memchr ya está vectorizado en la biblioteca estándar
+    if (i >= n) return n;
+    const void* p = memchr(s + i, c, n - i);
+    return p ? (size_t)((const char*)p - s) : n;
+}
+
+int contarCaracter(const char* s, size_t i, size_t fin, char c) {
+    int total = 0;
+#ifdef ESCANER_SIMD
+    while (i + Bloque::ANCHO <= fin) {
+        total += __builtin_popcount(Bloque::cargar(s + i).igual(c));
+        i += Bloque::ANCHO;
+    }
+#endif
+    for (; i < fin; i++) {
+        if (s[i] == c) total++;
+    }
+    return total;
+}
+
+const char* implementacionEscaner() {
+#ifdef ESCANER_SIMD
+    return ESCANER_SIMD;
+#else
+    return "escalar";
+#endif
+}
@@ -0,0 +1,57 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Clasificación de caracteres sin depender del locale (equivale a <cctype>
+// en el locale "C"): bytes >= 0x80 no son letras, dígitos ni espacios.
+enum ClaseCaracter : uint8_t {
+    CLASE_ESPACIO = 1,
+    CLASE_LETRA = 2,
+    CLASE_DIGITO = 4,
+    CLASE_IDENTIFICADOR = 8 // letra, dígito o '_'
+};
+
+struct TablaClases {
+    uint8_t clases[256];
+};
+
+constexpr TablaClases construirTablaClases() {
+    TablaClases tabla{};
+    for (int c = 0; c < 256; c++) {
+        uint8_t clase = 0;
+        if (c == ' ' || (c >= '\t' && c <= '\r')) clase |= CLASE_ESPACIO;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) clase |= CLASE_LETRA | CLASE_IDENTIFICADOR;
+        if (c >= '0' && c <= '9') clase |= CLASE_DIGITO | CLASE_IDENTIFICADOR;
+        if (c == '_') clase |= CLASE_IDENTIFICADOR;
+        tabla.clases[c] = clase;
+    }
+    return tabla;
+}
+
+constexpr TablaClases CLASES_CARACTER = construirTablaClases();
+
+inline bool esClase(char c, uint8_t clase) {
+    return (CLASES_CARACTER.clases[(unsigned char)c] & clase) != 0;
+}
+
+// Rutinas de escaneo por bloques (AVX2/SSE2 si están disponibles, escalar si no).
+// Todas trabajan sobre s[i..n) y devuelven la primera posición que no cumple
+// la condición, o n.
+
+// Salta espacios en blanco sumando a `linea` los '\n' encontrados.
+size_t saltarEspacios(const char* s, size_t i, size_t n, int& linea);
+// Fin de una secuencia de letras, dígitos y '_'.
+size_t finIdentificador(const char* s, size_t i, size_t n);
+// Fin de una secuencia de dígitos.
+size_t finDigitos(const char* s, size_t i, size_t n);
+// Posición del siguiente `c`, o n si no aparece.
+size_t buscarCaracter(const char* s, size_t i, size_t n, char c);
+// Número de apariciones de `c` en s[i..fin).
+int contarCaracter(const char* s, size_t i, size_t fin, char c);
+
+// "AVX2", "SSE2" o "escalar", según con qué se compiló el escáner.
+const char* implementacionEscaner();
+
+#endif
@@ -0,0 +1,202 @@
+#include "serializer.h"
+#include "parser.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const uint32_t ORDEN_BYTES = 0x01020304;
+
+// Niveles de nodos que admite el lector. Cada bloque o expresión que cuenta
+// el parser para MAX_ANIDAMIENTO pone como mucho dos nodos (Si y su bloque,
+// una llamada y su argumento...), y por encima quedan unos pocos más.
+const uint32_t MAX_ALTURA_AST = 2 * MAX_ANIDAMIENTO + 16;
+
+template <typename T>
+void escribirBloque(Emisor& salida, const T* datos, size_t n) {
+    salida << string_view(reinterpret_cast<const char*>(datos), n * sizeof(T));
+}
+
+// Ids de los nodos alcanzables desde la raíz, cada hijo antes que su padre
+// (los pases sobre el árbol crean nodos nuevos después de sus padres)
+vector<NodoId> postorden(const ArbolAST& arbol, vector<NodoId>& nuevoId) {
+    vector<NodoId> orden;
+    nuevoId.assign(arbol.nodos.size(), NODO_NULO);
+    vector<pair<NodoId, uint32_t>> pila; // nodo y siguiente hijo por visitar
+    if (arbol.raiz != NODO_NULO) pila.push_back({arbol.raiz, 0});
+    while (!pila.empty()) {
+        NodoId id = pila.back().first;
+        uint32_t siguiente = pila.back().second;
+        RangoHijos hijos = arbol.hijosDe(id);
+        if (siguiente < hijos.size()) {
+            pila.back().second++;
+            if (nuevoId[hijos[siguiente]] == NODO_NULO) pila.push_back({hijos[siguiente], 0});
+            continue;
+        }
+        nuevoId[id] = (NodoId)orden.size();
+        orden.push_back(id);
+        pila.pop_back();
+    }
+    return orden;
+}
+
+// Lo que el generador da por hecho de los árboles del parser: los nodos con
+// nombre tienen símbolo y un SubProceso tiene al menos parámetros y cuerpo
+bool formaValida(const NodoBinario& nodo) {
+    switch (nodo.tipo) {
+        case TipoNodo::FUNCION:
+            return nodo.numHijos >= 2 && nodo.simbolo != SIN_SIMBOLO;
+        case TipoNodo::PARA:
+        case TipoNodo::ASIGNACION:
+        case TipoNodo::IDENTIFICADOR:
+        case TipoNodo::DECLARACION:
+        case TipoNodo::DIMENSION:
+        case TipoNodo::ELEMENTO:
+        case TipoNodo::PARAMETRO:
+        case TipoNodo::LLAMADA:
+            return nodo.simbolo != SIN_SIMBOLO;
+        default:
+            return true;
+    }
+}
+
+} // namespace
+
+bool esASTSerializado(string_view datos) {
+    return datos.size() >= sizeof(MAGIA_AST) && memcmp(datos.data(), MAGIA_AST, sizeof(MAGIA_AST)) == 0;
+}
+
+void serializarAST(const ArbolAST& arbol, Emisor& salida) {
+    vector<NodoId> nuevoId;
+    vector<NodoId> orden = postorden(arbol, nuevoId);
+
+    vector<NodoBinario> nodos;
+    vector<NodoId> hijos;
+    string texto;
+    vector<SimboloId> nuevoSimbolo;
+    uint32_t numSimbolos = 0;
+    nodos.reserve(orden.size());
+    hijos.reserve(orden.size());
+    // Los identificadores se repiten mucho: cada texto distinto va una sola vez
+    unordered_map<string_view, uint32_t> posiciones;
+    for (NodoId id : orden) {
+        const NodoAST& nodo = arbol[id];
+        NodoBinario binario{nodo.tipo, nodo.operador, nodo.tipoDato, (uint8_t)nodo.arreglo,
+                            (uint32_t)hijos.size(), nodo.numHijos, nodo.simbolo, 0, (uint32_t)nodo.valor.size()};
+        for (NodoId hijo : arbol.hijosDe(id)) {
+            hijos.push_back(nuevoId[hijo]);
+        }
+        if (nodo.simbolo != SIN_SIMBOLO) {
+            if (nodo.simbolo >= nuevoSimbolo.size()) nuevoSimbolo.resize(nodo.simbolo + 1, SIN_SIMBOLO);
+            if (nuevoSimbolo[nodo.simbolo] == SIN_SIMBOLO) nuevoSimbolo[nodo.simbolo] = numSimbolos++;
+            binario.simbolo = nuevoSimbolo[nodo.simbolo];
+        }
+        if (!nodo.valor.empty()) {
+            auto [it, nuevo] = posiciones.emplace(nodo.valor, (uint32_t)texto.size());
+            if (nuevo) {
+                if (texto.size() + nodo.valor.size() > UINT32_MAX) {
+                    throw length_error("El texto del árbol no cabe en el formato serializado");
+                }
+                texto += nodo.valor;
+            }
+            binario.inicioValor = it->second;
+        }
+        nodos.push_back(binario);
+    }
+
+    CabeceraAST cabecera{};
+    memcpy(cabecera.magia, MAGIA_AST, sizeof(MAGIA_AST));
+    cabecera.version = VERSION_AST;
+    cabecera.ordenBytes = ORDEN_BYTES;
+    cabecera.numNodos = (uint32_t)nodos.size();
+    cabecera.numHijos = (uint32_t)hijos.size();
+    cabecera.bytesTexto = (uint32_t)texto.size();
+    cabecera.numSimbolos = numSimbolos;
+    cabecera.raiz = orden.empty() ? NODO_NULO : (NodoId)(orden.size() - 1);
+
+    escribirBloque(salida, &cabecera, 1);
+    escribirBloque(salida, nodos.data(), nodos.size());
+    escribirBloque(salida, hijos.data(), hijos.size());
+    salida << texto;
+}
+
+string serializarAST(const ArbolAST& arbol) {
+    Emisor salida;
+    serializarAST(arbol, salida);
+    return salida.tomarTexto();
+}
+
+VistaAST::VistaAST(string_view datos) {
+    if (datos.size() < sizeof(CabeceraAST) || !esASTSerializado(datos)) {
+        throw runtime_error("No es un árbol serializado");
+    }
+    if ((uintptr_t)datos.data() % alignof(CabeceraAST) != 0) {
+        throw runtime_error("Árbol serializado en memoria sin alinear");
+    }
+    cabecera = reinterpret_cast<const CabeceraAST*>(datos.data());
+    if (cabecera->ordenBytes != ORDEN_BYTES) {
+        throw runtime_error("Árbol serializado con otro orden de bytes");
+    }
+    if (cabecera->version != VERSION_AST) {
+        throw runtime_error("Versión de árbol serializado no soportada: " + to_string(cabecera->version));
+    }
+    uint64_t tam = sizeof(CabeceraAST) + (uint64_t)cabecera->numNodos * sizeof(NodoBinario) +
+                   (uint64_t)cabecera->numHijos * sizeof(NodoId) + cabecera->bytesTexto;
+    if (tam != datos.size()) {
+        throw runtime_error("Árbol serializado truncado o con tamaños incorrectos");
+    }
+    if ((cabecera->raiz != NODO_NULO && cabecera->raiz >= cabecera->numNodos) ||
+        cabecera->numSimbolos > cabecera->numNodos) {
+        throw runtime_error("Árbol serializado con la raíz o los símbolos fuera de rango");
+    }
+
+    nodos = reinterpret_cast<const NodoBinario*>(datos.data() + sizeof(CabeceraAST));
+    hijos = reinterpret_cast<const NodoId*>(nodos + cabecera->numNodos);
+    texto = reinterpret_cast<const char*>(hijos + cabecera->numHijos);
+
+    // Cada nodo con un solo padre (como en postorden) y sin ramas más hondas de
+    // lo que deja el parser: si no, el generador, que es recursivo, podría
+    // desbordar la pila o recorrer el mismo nodo un número exponencial de veces
+    vector<uint32_t> altura(cabecera->numNodos, 1);
+    vector<bool> conPadre(cabecera->numNodos, false);
+    for (NodoId id = 0; id < cabecera->numNodos; id++) {
+        const NodoBinario& nodo = nodos[id];
+        bool valido = nodo.tipo <= TipoNodo::LLAMADA && formaValida(nodo) && nodo.operador <= Operador::COMA &&
+                      nodo.tipoDato <= TipoDato::CADENA &&
+                      (nodo.simbolo == SIN_SIMBOLO || nodo.simbolo < cabecera->numSimbolos) &&
+                      (uint64_t)nodo.primerHijo + nodo.numHijos <= cabecera->numHijos &&
+                      (uint64_t)nodo.inicioValor + nodo.longitudValor <= cabecera->bytesTexto;
+        for (size_t i = 0; valido && i < nodo.numHijos; i++) {
+            NodoId hijo = hijos[nodo.primerHijo + i];
+            valido = hijo < id && !conPadre[hijo];
+            if (valido) {
+                conPadre[hijo] = true;
+                altura[id] = max(altura[id], altura[hijo] + 1);
+            }
+        }
+        valido = valido && altura[id] <= MAX_ALTURA_AST;
+        if (!valido) {
+            throw runtime_error("Nodo " + to_string(id) + " del árbol serializado no válido");
+        }
+    }
+}
+
+void cargarAST(const VistaAST& vista, ArbolAST& arbol) {
+    arbol.limpiar();
+    arbol.nodos.resize(vista.size());
+    for (NodoId id = 0; id < vista.size(); id++) {
+        const NodoBinario& nodo = vista[id];
+        arbol.nodos[id] = {nodo.tipo, nodo.operador, nodo.tipoDato, nodo.arreglo != 0, nodo.primerHijo,
+                           nodo.numHijos, nodo.simbolo, vista.valor(id)};
+    }
+    // Los rangos de hijos ya tienen el formato de la arena: se copian de una vez
+    RangoHijos hijos = vista.listaHijos();
+    arbol.hijos.assign(hijos.begin(), hijos.end());
+    arbol.raiz = vista.raiz();
+}
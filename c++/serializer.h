@@ -0,0 +1,102 @@
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "ast.h"
+#include "emitter.h"
+
+using namespace std;
+
+// Formato binario del árbol ya analizado (tras optimizar e inferir tipos),
+// para pasar programas entre procesos o guardarlos sin volver a analizarlos.
+// No tiene punteros: todo son índices, así se puede mapear un archivo y
+// recorrerlo en el sitio con VistaAST.
+//
+//   CabeceraAST
+//   NodoBinario[numNodos]   hijos de cada nodo = rango de la lista de hijos
+//   NodoId[numHijos]
+//   char[bytesTexto]        valores de los nodos, cada texto distinto una vez
+//
+// Los nodos van en postorden desde la raíz (cada hijo antes que su padre) y
+// solo se guardan los alcanzables; los símbolos se renumeran por orden de
+// aparición, así el árbol no depende de la tabla con la que se analizó. Los enteros van en el orden de bytes de
+// la máquina que lo escribió; el lector comprueba que coincide.
+
+const char MAGIA_AST[4] = {'\x89', 'A', 'S', 'T'};
+const uint32_t VERSION_AST = 1;
+
+struct CabeceraAST {
+    char magia[4];
+    uint32_t version;
+    uint32_t ordenBytes; // 0x01020304 escrito en el orden de quien lo generó
+    uint32_t numNodos;
+    uint32_t numHijos;
+    uint32_t bytesTexto;
+    uint32_t numSimbolos; // ids de símbolo renumerados de 0 a numSimbolos - 1
+    NodoId raiz;
+};
+
+struct NodoBinario {
+    TipoNodo tipo;
+    Operador operador;
+    TipoDato tipoDato;
+    uint8_t arreglo;
+    uint32_t primerHijo;
+    uint32_t numHijos;
+    SimboloId simbolo;
+    uint32_t inicioValor; // desde el principio del texto
+    uint32_t longitudValor;
+};
+
+static_assert(sizeof(CabeceraAST) == 32, "CabeceraAST forma parte del formato");
+static_assert(sizeof(NodoBinario) == 24, "NodoBinario forma parte del formato");
+
+// true si `datos` empieza como un árbol serializado (y no como pseudocódigo)
+bool esASTSerializado(string_view datos);
+
+// Escribe el árbol alcanzable desde arbol.raiz. Lanza length_error si no cabe
+// en los índices de 32 bits del formato.
+void serializarAST(const ArbolAST& arbol, Emisor& salida);
+string serializarAST(const ArbolAST& arbol);
+
+// Vista de solo lectura sobre un árbol serializado. El constructor comprueba
+// la cabecera, los tamaños y que cada nodo solo apunte a hijos anteriores que
+// no tengan ya otro padre, a texto dentro del buffer y a símbolos en rango,
+// con la forma que espera el generador y sin más niveles de los que admite el
+// parser (lanza runtime_error si no): recorrerlo o generarlo nunca sale del
+// buffer, ni entra en un ciclo, ni pasa dos veces por un nodo, ni desborda la
+// pila, aunque el archivo venga de fuera. `datos` debe seguir vivo y alineado
+// a 4 bytes (lo están un mmap y la memoria de un string).
+class VistaAST {
+public:
+    explicit VistaAST(string_view datos);
+
+    NodoId raiz() const { return cabecera->raiz; }
+    size_t size() const { return cabecera->numNodos; }
+    size_t numSimbolos() const { return cabecera->numSimbolos; }
+    const NodoBinario& operator[](NodoId id) const { return nodos[id]; }
+
+    RangoHijos hijosDe(NodoId id) const {
+        const NodoId* base = hijos + nodos[id].primerHijo;
+        return {base, base + nodos[id].numHijos};
+    }
+
+    // Todos los rangos de hijos seguidos, como ArbolAST::hijos
+    RangoHijos listaHijos() const { return {hijos, hijos + cabecera->numHijos}; }
+
+    string_view valor(NodoId id) const { return string_view(texto + nodos[id].inicioValor, nodos[id].longitudValor); }
+
+private:
+    const CabeceraAST* cabecera;
+    const NodoBinario* nodos;
+    const NodoId* hijos;
+    const char* texto;
+};
+
+// Rellena `arbol` con los nodos de `vista`. Los valores apuntan al texto de
+// la vista (no se copia): sus datos deben vivir lo mismo que el árbol.
+void cargarAST(const VistaAST& vista, ArbolAST& arbol);
+
+#endif
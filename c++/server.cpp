@@ -0,0 +1,148 @@
+#include "server.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include "incremental.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define USAR_POSIX 1
+#endif
+
+using namespace std;
+
+#ifdef USAR_POSIX
+
+namespace {
+
+// Límite de una petición (evita reservar cantidades absurdas con cabeceras rotas)
+const uint32_t MAX_PETICION = 256u << 20;
+
+bool leerExacto(int fd, char* datos, size_t n) {
+    while (n > 0) {
+        ssize_t leidos = read(fd, datos, n);
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos <= 0) return false;
+        datos += leidos;
+        n -= leidos;
+    }
+    return true;
+}
+
+bool escribirExacto(int fd, const char* datos, size_t n) {
+    while (n > 0) {
+        ssize_t escritos = write(fd, datos, n);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) return false;
+        datos += escritos;
+        n -= escritos;
+    }
+    return true;
+}
+
+bool responder(int fd, uint8_t estado, string_view contenido) {
+    uint32_t n = (uint32_t)contenido.size();
+    char cabecera[5] = {(char)estado, (char)(n & 0xFF), (char)((n >> 8) & 0xFF),
+                        (char)((n >> 16) & 0xFF), (char)((n >> 24) & 0xFF)};
+    return escribirExacto(fd, cabecera, sizeof(cabecera)) &&
+           escribirExacto(fd, contenido.data(), contenido.size());
+}
+
+// Atiende peticiones hasta que el cliente cierra o hay un error de E/S
+void atender(int entrada, int salida, const OpcionesCompilacion& opciones) {
+    Compilador compilador(opciones);
+    CompilacionIncremental incremental(opciones);
+    string fuente;
+
+    for (;;) {
+        unsigned char cabecera[4];
+        if (!leerExacto(entrada, (char*)cabecera, sizeof(cabecera))) return;
+        uint32_t longitud = cabecera[0] | (cabecera[1] << 8) | (cabecera[2] << 16) | ((uint32_t)cabecera[3] << 24);
+        if (longitud > MAX_PETICION) {
+            responder(salida, 1, "Petición demasiado grande");
+            return;
+        }
+
+        fuente.resize(longitud);
+        if (!leerExacto(entrada, &fuente[0], longitud)) return;
+
+        bool ok;
+        try {
+            ok = opciones.incremental && !opciones.emitirAST ? responder(salida, 0, incremental.compilar(fuente))
+                                      : responder(salida, 0, compilador.compilarEnBuffer(fuente));
+        } catch (const exception& e) {
+            ok = responder(salida, 1, e.what());
+        }
+        if (!ok) return;
+    }
+}
+
+} // namespace
+
+int servirEntradaEstandar(const OpcionesCompilacion& opciones) {
+    signal(SIGPIPE, SIG_IGN);
+    atender(STDIN_FILENO, STDOUT_FILENO, opciones);
+    return 0;
+}
+
+int servirSocket(const string& ruta, const OpcionesCompilacion& opciones) {
+    signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un direccion{};
+    direccion.sun_family = AF_UNIX;
+    if (ruta.size() >= sizeof(direccion.sun_path)) {
+        cerr << "Error: ruta de socket demasiado larga: " << ruta << endl;
+        return 1;
+    }
+    strcpy(direccion.sun_path, ruta.c_str());
+
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0) {
+        cerr << "Error: no se pudo crear el socket: " << strerror(errno) << endl;
+        return 1;
+    }
+    unlink(ruta.c_str());
+    if (bind(servidor, (sockaddr*)&direccion, sizeof(direccion)) < 0 || listen(servidor, 16) < 0) {
+        cerr << "Error: no se pudo escuchar en " << ruta << ": " << strerror(errno) << endl;
+        close(servidor);
+        return 1;
+    }
+    cerr << "Servidor escuchando en " << ruta << endl;
+
+    for (;;) {
+        int cliente = accept(servidor, nullptr, nullptr);
+        if (cliente < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error en accept: " << strerror(errno) << endl;
+            break;
+        }
+        thread([cliente, opciones]() {
+            atender(cliente, cliente, opciones);
+            close(cliente);
+        }).detach();
+    }
+
+    close(servidor);
+    unlink(ruta.c_str());
+    return 1;
+}
+
+#else
+
+int servirEntradaEstandar(const OpcionesCompilacion&) {
+    cerr << "Error: el modo servidor solo está disponible en sistemas POSIX." << endl;
+    return 1;
+}
+
+int servirSocket(const string&, const OpcionesCompilacion&) {
+    cerr << "Error: el modo servidor solo está disponible en sistemas POSIX." << endl;
+    return 1;
+}
+
+#endif
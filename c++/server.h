@@ -0,0 +1,24 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include "compiler.h"
+
+using namespace std;
+
+// Modo servidor para el pipeline de voz: recibe pseudocódigo y devuelve el
+// C++ generado sin tocar el disco ni lanzar procesos.
+//
+// Petición:  uint32 longitud (little-endian) + pseudocódigo
+// Respuesta: uint8 estado (0 = ok, 1 = error) + uint32 longitud + C++ o mensaje
+//
+// La petición también puede ser un árbol serializado (serializer.h) y, con
+// OpcionesCompilacion::emitirAST, la respuesta es el árbol en vez del C++
+// (sin modo incremental): así un cliente analiza una vez y genera después.
+
+// Atiende peticiones por stdin/stdout hasta fin de archivo.
+int servirEntradaEstandar(const OpcionesCompilacion& opciones);
+// Escucha en un socket Unix; cada conexión se atiende en su propio hilo.
+int servirSocket(const string& ruta, const OpcionesCompilacion& opciones);
+
+#endif
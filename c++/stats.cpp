@@ -0,0 +1,156 @@
+#include "stats.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "compiler.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define USAR_POSIX 1
+#endif
+
+using namespace std;
+
+namespace {
+
+atomic<bool> contando{false};
+atomic<bool> disponible{false};
+thread_local ContadorMemoria memoriaHilo{0, 0};
+
+double ms(uint64_t ns) {
+    return ns / 1e6;
+}
+
+void escribirCadenaJson(ostream& os, const string& texto) {
+    os << '"';
+    for (char c : texto) {
+        switch (c) {
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        case '\r': os << "\\r"; break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)c);
+                os << escape;
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+void escribirCamposJson(ostream& os, const EstadisticasCompilacion& e) {
+    os << "\"bytes_entrada\":" << e.bytesEntrada
+       << ",\"bytes_salida\":" << e.bytesSalida
+       << ",\"tokens\":" << e.tokens
+       << ",\"nodos\":" << e.nodos
+       << ",\"ms_lexico\":" << ms(e.nsLexico)
+       << ",\"ms_sintaxis\":" << ms(e.nsSintaxis)
+       << ",\"ms_generacion\":" << ms(e.nsGeneracion)
+       << ",\"ms_guardado\":" << ms(e.nsGuardado);
+    if (contadorMemoriaDisponible()) {
+        os << ",\"reservas\":" << e.reservas << ",\"bytes_reservados\":" << e.bytesReservados;
+    }
+}
+
+} // namespace
+
+void EstadisticasCompilacion::acumular(const EstadisticasCompilacion& otra) {
+    archivos += otra.archivos;
+    bytesEntrada += otra.bytesEntrada;
+    bytesSalida += otra.bytesSalida;
+    tokens += otra.tokens;
+    nodos += otra.nodos;
+    nsLexico += otra.nsLexico;
+    nsSintaxis += otra.nsSintaxis;
+    nsGeneracion += otra.nsGeneracion;
+    nsGuardado += otra.nsGuardado;
+    reservas += otra.reservas;
+    bytesReservados += otra.bytesReservados;
+    sinReservas += otra.sinReservas;
+}
+
+uint64_t relojNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void activarContadorMemoria() {
+    contando.store(true, memory_order_relaxed);
+}
+
+bool contadorMemoriaActivo() {
+    return contando.load(memory_order_relaxed);
+}
+
+void declararContadorMemoria() {
+    disponible.store(true, memory_order_relaxed);
+}
+
+bool contadorMemoriaDisponible() {
+    return disponible.load(memory_order_relaxed);
+}
+
+void registrarReserva(size_t bytes) {
+    memoriaHilo.reservas++;
+    memoriaHilo.bytes += bytes;
+}
+
+ContadorMemoria memoriaDelHilo() {
+    return memoriaHilo;
+}
+
+size_t picoMemoriaKiB() {
+#ifdef USAR_POSIX
+    rusage uso{};
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+#ifdef __APPLE__
+    return uso.ru_maxrss / 1024; // macOS lo da en bytes
+#else
+    return uso.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+void escribirEstadisticasTexto(ostream& os, const EstadisticasCompilacion& total, double msTotal) {
+    os << "Estadísticas:\n";
+    os << "  archivos:          " << total.archivos << "\n";
+    os << "  entrada:           " << total.bytesEntrada << " bytes\n";
+    os << "  salida:            " << total.bytesSalida << " bytes\n";
+    os << "  tokens:            " << total.tokens << "\n";
+    os << "  nodos AST:         " << total.nodos << "\n";
+    os << "  léxico:            " << ms(total.nsLexico) << " ms\n";
+    os << "  sintaxis:          " << ms(total.nsSintaxis) << " ms\n";
+    os << "  generación:        " << ms(total.nsGeneracion) << " ms\n";
+    os << "  guardado:          " << ms(total.nsGuardado) << " ms\n";
+    os << "  total:             " << msTotal << " ms\n";
+    if (contadorMemoriaDisponible()) {
+        os << "  reservas:          " << total.reservas << " (" << total.bytesReservados << " bytes; "
+           << total.sinReservas << " de " << total.archivos << " archivos sin ninguna)\n";
+    }
+    os << "  pico de memoria:   " << picoMemoriaKiB() << " KiB\n";
+}
+
+void escribirEstadisticasJson(ostream& os, const EstadisticasCompilacion& total, double msTotal,
+                              const vector<ResultadoCompilacion>& resultados) {
+    os << "{\"archivos\":" << total.archivos << ",";
+    escribirCamposJson(os, total);
+    if (contadorMemoriaDisponible()) os << ",\"archivos_sin_reservas\":" << total.sinReservas;
+    os << ",\"ms_total\":" << msTotal << ",\"pico_rss_kib\":" << picoMemoriaKiB() << ",\"por_archivo\":[";
+    for (size_t i = 0; i < resultados.size(); i++) {
+        const ResultadoCompilacion& resultado = resultados[i];
+        if (i > 0) os << ",";
+        os << "{\"entrada\":";
+        escribirCadenaJson(os, resultado.entrada);
+        os << ",\"exito\":" << (resultado.exito ? "true" : "false") << ",";
+        escribirCamposJson(os, resultado.estadisticas);
+        os << "}";
+    }
+    os << "]}\n";
+}
@@ -0,0 +1,59 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+struct ResultadoCompilacion;
+
+// Medidas de una o varias compilaciones (--stats). Los tiempos son de reloj
+// monótono; las reservas son las del hilo que compiló y solo se cuentan si el
+// ejecutable enlaza contador_memoria.cpp.
+struct EstadisticasCompilacion {
+    size_t archivos = 0;
+    size_t bytesEntrada = 0;
+    size_t bytesSalida = 0;
+    size_t tokens = 0;
+    size_t nodos = 0;
+    uint64_t nsLexico = 0;
+    uint64_t nsSintaxis = 0;
+    uint64_t nsGeneracion = 0;
+    uint64_t nsGuardado = 0;
+    uint64_t reservas = 0;
+    uint64_t bytesReservados = 0;
+    // Compilaciones que no reservaron nada: a partir de la primera de cada
+    // Compilador deberían ser todas (reutiliza su memoria)
+    size_t sinReservas = 0;
+
+    void acumular(const EstadisticasCompilacion& otra);
+};
+
+uint64_t relojNs();
+
+// Contador de reservas del hilo actual. El operador new de contador_memoria.cpp
+// llama a registrarReserva solo mientras el contador está activo.
+struct ContadorMemoria {
+    uint64_t reservas;
+    uint64_t bytes;
+};
+void declararContadorMemoria(); // lo llama contador_memoria.cpp al inicializarse
+void activarContadorMemoria();
+bool contadorMemoriaActivo();
+bool contadorMemoriaDisponible();
+void registrarReserva(size_t bytes);
+ContadorMemoria memoriaDelHilo();
+
+// Máximo de memoria residente del proceso en KiB (0 si no se puede saber)
+size_t picoMemoriaKiB();
+
+// Informes de --stats: `total` es la suma de `resultados`, `msTotal` el tiempo
+// de pared de toda la ejecución. El JSON incluye el detalle por archivo.
+void escribirEstadisticasTexto(ostream& os, const EstadisticasCompilacion& total, double msTotal);
+void escribirEstadisticasJson(ostream& os, const EstadisticasCompilacion& total, double msTotal,
+                              const vector<ResultadoCompilacion>& resultados);
+
+#endif
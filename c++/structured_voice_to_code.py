@@ -2,7 +2,8 @@
 import os
 import argparse
 import torch
-from transformers import pipeline
+from transcription_service import obtener_transcriptor, dictar
+from ejecucion import ejecutar_pseudocodigo
 import sounddevice as sd
 import numpy as np
 import scipy.io.wavfile as wav
@@ -25,8 +26,8 @@ def save_audio(audio, sample_rate, filename="temp_audio.wav"):
 def transcribe_audio(audio_file, model_name="openai/whisper-base"):
     """Transcribe el audio a texto usando un modelo transformer."""
     try:
-        print(f"Cargando modelo {model_name}...")
-        transcriber = pipeline("automatic-speech-recognition", model=model_name)
+        # El modelo se carga una vez por proceso y se reutiliza
+        transcriber = obtener_transcriptor(model_name)
         print("Transcribiendo audio...")
         result = transcriber(audio_file)
         
@@ -145,9 +146,31 @@ def save_pseudocode(text, filename="input.pseudo"):
     return filename
 
 def compile_pseudocode(pseudo_file, compiler_path="./build/proyecto_compiladores"):
-    """Compila el pseudocódigo usando el compilador C++."""
+    """Compila el pseudocódigo usando el compilador C++.
+
+    Si está construida libpseudocompilador.so compila en este mismo proceso;
+    si no, lanza el ejecutable.
+    """
+    import compilador_nativo
+    if compilador_nativo.disponible(compiler_path):
+        cpp_file = os.path.splitext(os.path.basename(pseudo_file))[0] + ".cpp"
+        try:
+            with open(pseudo_file, "rb") as f:
+                content = f.read()
+            with compilador_nativo.CompiladorNativo(compiler_path=compiler_path) as compilador:
+                code = compilador.compilar_buffer(content)
+                with open(cpp_file, "wb") as f:
+                    f.write(code)
+            print("Compilación exitosa:")
+            print(f"Código C++ generado en: {cpp_file}")
+        except compilador_nativo.ErrorCompilacion as e:
+            print("Error en la compilación:")
+            print(e)
+        except OSError as e:
+            print(f"Error al ejecutar el compilador: {e}")
+        return
     try:
-        result = subprocess.run([compiler_path, pseudo_file], 
+        result = subprocess.run([compiler_path, "--ignorar-mayusculas", pseudo_file], 
                                capture_output=True, text=True)
         if result.returncode == 0:
             print("Compilación exitosa:")
@@ -192,9 +215,17 @@ def main():
     parser.add_argument("--output", type=str, default="input.pseudo", help="Nombre del archivo de pseudocódigo")
     parser.add_argument("--compile", action="store_true", help="Compilar automáticamente el pseudocódigo")
     parser.add_argument("--edit", action="store_true", help="Abrir el pseudocódigo en un editor antes de compilar")
+    parser.add_argument("--run", action="store_true",
+                        help="Ejecutar el programa al momento con el intérprete (g++ solo si tarda)")
+    parser.add_argument("--stream", action="store_true",
+                        help="Dictado continuo: compila tras cada frase con el modelo y el compilador residentes")
     
     args = parser.parse_args()
     
+    if args.stream:
+        dictar(convert_to_pseudocode, args.model, "./build/proyecto_compiladores", args.output)
+        return
+    
     # Grabar audio
     audio, sample_rate = record_audio(duration=args.duration)
     
@@ -236,5 +267,9 @@ def main():
             print("Puedes editar el archivo manualmente y luego compilarlo con:")
             print(f"./build/proyecto_compiladores {pseudo_file}")
 
+    if args.run and is_valid:
+        print("Ejecutando el programa...")
+        ejecutar_pseudocodigo(pseudo_file)
+
 if __name__ == "__main__":
     main()
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "symbols.h"
+#include <cstring>
+#include <functional>
+
+using namespace std;
+
+SimboloId TablaSimbolos::internar(string_view nombre) {
+    if (2 * (nombres.size() + 1) > indice.size()) agrandarIndice();
+    size_t mascara = indice.size() - 1;
+    for (size_t i = hash<string_view>()(nombre) & mascara;; i = (i + 1) & mascara) {
+        Ranura& ranura = indice[i];
+        if (ranura.generacion != generacion) {
+            SimboloId id = (SimboloId)nombres.size();
+            nombres.push_back(copias.copiar(nombre));
+            ranura = {generacion, id};
+            return id;
+        }
+        if (nombres[ranura.id] == nombre) return ranura.id;
+    }
+}
+
+void TablaSimbolos::agrandarIndice() {
+    vector<Ranura> anterior = move(indice);
+    indice.assign(anterior.empty() ? 64 : 2 * anterior.size(), Ranura{0, 0});
+    size_t mascara = indice.size() - 1;
+    for (const Ranura& ranura : anterior) {
+        if (ranura.generacion != generacion) continue;
+        size_t i = hash<string_view>()(nombres[ranura.id]) & mascara;
+        while (indice[i].generacion == generacion) i = (i + 1) & mascara;
+        indice[i] = ranura;
+    }
+}
+
+// Los textos se copian seguidos
+string_view AlmacenTexto::copiar(string_view texto) {
+    if (texto.empty()) return string_view();
+    if (texto.size() > TAM_BLOQUE - usadoEnBloque) {
+        if (texto.size() > TAM_BLOQUE) {
+            // Texto enorme: bloque propio, que no se reutiliza
+            grandes.push_back(make_unique<char[]>(texto.size()));
+            memcpy(grandes.back().get(), texto.data(), texto.size());
+            return string_view(grandes.back().get(), texto.size());
+        }
+        if (bloquesUsados == bloques.size()) bloques.push_back(make_unique<char[]>(TAM_BLOQUE));
+        bloquesUsados++;
+        usadoEnBloque = 0;
+    }
+    char* destino = bloques[bloquesUsados - 1].get() + usadoEnBloque;
+    memcpy(destino, texto.data(), texto.size());
+    usadoEnBloque += texto.size();
+    return string_view(destino, texto.size());
+}
+
+void AlmacenTexto::limpiar() {
+    grandes.clear();
+    bloquesUsados = 0;
+    usadoEnBloque = TAM_BLOQUE;
+}
+
+void TablaSimbolos::limpiar() {
+    // Tras 2^32 - 1 generaciones las ranuras viejas volverían a parecer válidas
+    if (++generacion == 0) {
+        indice.assign(indice.size(), Ranura{0, 0});
+        generacion = 1;
+    }
+    nombres.clear();
+    copias.limpiar();
+}
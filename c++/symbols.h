@@ -0,0 +1,83 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Identificador denso de un nombre de variable: 0, 1, 2... en el orden en que
+// el lexer los encuentra. Las fases siguientes comparan ids en vez de cadenas.
+typedef uint32_t SimboloId;
+const SimboloId SIN_SIMBOLO = UINT32_MAX;
+
+// Copias de textos en bloques que no se mueven nunca: las vistas devueltas
+// siguen valiendo hasta limpiar(), que conserva los bloques para reutilizarlos.
+class AlmacenTexto {
+public:
+    string_view copiar(string_view texto);
+    void limpiar();
+
+private:
+    static constexpr size_t TAM_BLOQUE = 16 * 1024;
+
+    vector<unique_ptr<char[]>> bloques;
+    vector<unique_ptr<char[]>> grandes; // textos de más de TAM_BLOQUE
+    size_t bloquesUsados = 0;
+    size_t usadoEnBloque = TAM_BLOQUE;
+};
+
+// Tabla de símbolos (interner). Guarda su propia copia de cada nombre, así un
+// id sigue siendo válido aunque el texto fuente donde apareció ya no exista
+// (la compilación incremental la conserva entre versiones del programa).
+class TablaSimbolos {
+public:
+    // Id de `nombre`, creándolo si es la primera vez que aparece
+    SimboloId internar(string_view nombre);
+    string_view nombre(SimboloId id) const { return nombres[id]; }
+    size_t size() const { return nombres.size(); }
+    // Olvida los nombres en O(1); conserva la memoria ya reservada
+    void limpiar();
+
+private:
+    // Índice con direccionamiento abierto: una ranura es válida si es de la
+    // generación actual, así limpiar() no tiene que recorrerlo
+    struct Ranura {
+        uint32_t generacion;
+        SimboloId id;
+    };
+
+    void agrandarIndice();
+
+    vector<Ranura> indice; // potencia de 2, como mucho medio lleno
+    uint32_t generacion = 1;
+    vector<string_view> nombres;
+    AlmacenTexto copias; // las claves del índice
+};
+
+// Conjunto de símbolos como mapa de bits indexado por id
+class ConjuntoSimbolos {
+public:
+    bool contiene(SimboloId id) const {
+        size_t palabra = id / 64;
+        return palabra < bits.size() && (bits[palabra] >> (id % 64) & 1);
+    }
+    // true si no estaba
+    bool insertar(SimboloId id) {
+        size_t palabra = id / 64;
+        if (palabra >= bits.size()) bits.resize(palabra + 1, 0);
+        uint64_t mascara = uint64_t(1) << (id % 64);
+        if (bits[palabra] & mascara) return false;
+        bits[palabra] |= mascara;
+        return true;
+    }
+    void limpiar() { bits.clear(); }
+    void swap(ConjuntoSimbolos& otro) { bits.swap(otro.bits); }
+
+private:
+    vector<uint64_t> bits;
+};
+
+#endif
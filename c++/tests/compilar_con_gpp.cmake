@@ -0,0 +1,60 @@
+# Comprueba que el C++ generado compila. Se lanza desde ctest:
+#   cmake -DCOMPILADOR=<proyecto_compiladores> -DCXX=<g++> -DDIRECTORIO=<temporal>
+#         [-DFUENTE=<archivo.pseudo>]
+#         [-DGENERADOR=<generar_pseudo> -DSEMILLAS=<primera>-<última> -DLINEAS=N -DPROFUNDIDAD=D]
+#         -P compilar_con_gpp.cmake
+# Con FUENTE además ejecuta el programa y su salida tiene que ser la del
+# intérprete (--ejecutar). Con GENERADOR compila los programas sintéticos de
+# cada semilla.
+
+file(MAKE_DIRECTORY "${DIRECTORIO}")
+
+# Genera el C++ de `pseudo` en `cpp` y lo compila (solo el análisis si
+# `ejecutable` está vacío)
+function(compilar pseudo cpp ejecutable)
+    execute_process(COMMAND "${COMPILADOR}" --stdout "${pseudo}"
+                    OUTPUT_FILE "${cpp}" ERROR_VARIABLE error RESULT_VARIABLE resultado)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "${COMPILADOR} no compiló ${pseudo}:\n${error}")
+    endif()
+    if(ejecutable)
+        set(salida -o "${ejecutable}")
+    else()
+        set(salida -fsyntax-only)
+    endif()
+    execute_process(COMMAND "${CXX}" -std=c++17 ${salida} "${cpp}"
+                    ERROR_VARIABLE error RESULT_VARIABLE resultado)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "${CXX} no compiló el C++ generado para ${pseudo}:\n${error}")
+    endif()
+endfunction()
+
+if(FUENTE)
+    get_filename_component(nombre "${FUENTE}" NAME_WE)
+    compilar("${FUENTE}" "${DIRECTORIO}/${nombre}.cpp" "${DIRECTORIO}/${nombre}")
+    execute_process(COMMAND "${DIRECTORIO}/${nombre}" OUTPUT_VARIABLE compilado RESULT_VARIABLE resultado)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "El programa de ${FUENTE} terminó con ${resultado}")
+    endif()
+    execute_process(COMMAND "${COMPILADOR}" --ejecutar "${FUENTE}" OUTPUT_VARIABLE interpretado
+                    ERROR_VARIABLE error RESULT_VARIABLE resultado)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "--ejecutar falló con ${FUENTE}:\n${error}")
+    endif()
+    if(NOT compilado STREQUAL interpretado)
+        message(FATAL_ERROR "Salidas distintas para ${FUENTE}\ng++:\n${compilado}\n--ejecutar:\n${interpretado}")
+    endif()
+endif()
+
+if(GENERADOR)
+    string(REPLACE "-" ";" rango "${SEMILLAS}")
+    foreach(semilla RANGE ${rango})
+        set(pseudo "${DIRECTORIO}/sintetico${semilla}.pseudo")
+        execute_process(COMMAND "${GENERADOR}" --lineas ${LINEAS} --profundidad ${PROFUNDIDAD} --semilla ${semilla}
+                        OUTPUT_FILE "${pseudo}" RESULT_VARIABLE resultado)
+        if(NOT resultado EQUAL 0)
+            message(FATAL_ERROR "${GENERADOR} falló con la semilla ${semilla}")
+        endif()
+        compilar("${pseudo}" "${DIRECTORIO}/sintetico${semilla}.cpp" "")
+    endforeach()
+endif()
@@ -0,0 +1,84 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct ColaTrabajo {
+    mutex m;
+    deque<size_t> tareas;
+};
+
+// El dueño toma del final de su cola; los ladrones, del principio.
+bool tomarTarea(vector<unique_ptr<ColaTrabajo>>& colas, unsigned propia, size_t& tarea) {
+    {
+        ColaTrabajo& cola = *colas[propia];
+        lock_guard<mutex> lock(cola.m);
+        if (!cola.tareas.empty()) {
+            tarea = cola.tareas.back();
+            cola.tareas.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < colas.size(); k++) {
+        ColaTrabajo& victima = *colas[(propia + k) % colas.size()];
+        lock_guard<mutex> lock(victima.m);
+        if (!victima.tareas.empty()) {
+            tarea = victima.tareas.front();
+            victima.tareas.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void ejecutarConRobo(size_t numTareas, unsigned hilos, const function<void(unsigned, size_t)>& tarea) {
+    hilos = (unsigned)max<size_t>(1, min<size_t>(hilos, numTareas));
+    if (hilos == 1) {
+        for (size_t i = 0; i < numTareas; i++) tarea(0, i);
+        return;
+    }
+
+    // No se añaden tareas después de repartirlas: si ninguna cola tiene
+    // trabajo, el trabajador puede terminar.
+    vector<unique_ptr<ColaTrabajo>> colas;
+    for (unsigned h = 0; h < hilos; h++) {
+        colas.push_back(make_unique<ColaTrabajo>());
+        size_t desde = numTareas * h / hilos;
+        size_t hasta = numTareas * (h + 1) / hilos;
+        for (size_t i = hasta; i > desde; i--) colas[h]->tareas.push_back(i - 1);
+    }
+
+    mutex mError;
+    exception_ptr primerError;
+    vector<thread> trabajadores;
+    for (unsigned h = 0; h < hilos; h++) {
+        trabajadores.emplace_back([&, h]() {
+            size_t indice;
+            while (tomarTarea(colas, h, indice)) {
+                try {
+                    tarea(h, indice);
+                } catch (...) {
+                    lock_guard<mutex> lock(mError);
+                    if (!primerError) primerError = current_exception();
+                }
+            }
+        });
+    }
+    for (thread& t : trabajadores) t.join();
+
+    if (primerError) rethrow_exception(primerError);
+}
+
+unsigned hilosDisponibles() {
+    return max(1u, thread::hardware_concurrency());
+}
@@ -0,0 +1,20 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+// Ejecuta las tareas [0, numTareas) en `hilos` trabajadores con robo de
+// trabajo: cada trabajador empieza con un bloque contiguo de tareas en su
+// propia cola y, al vaciarla, roba del principio de las colas de los demás.
+// `tarea(trabajador, indice)` recibe el número de trabajador (0..hilos-1) para
+// que cada uno use su propio estado. Bloquea hasta terminar; si alguna tarea
+// lanza una excepción, se relanza la primera después de esperar al resto.
+void ejecutarConRobo(size_t numTareas, unsigned hilos, const function<void(unsigned, size_t)>& tarea);
+
+// Número de hilos por defecto (núcleos disponibles, al menos 1)
+unsigned hilosDisponibles();
+
+#endif
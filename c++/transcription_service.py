@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+"""Servicio de transcripción residente para el pipeline de voz.
+
+Carga el modelo de Whisper una sola vez por proceso (``obtener_transcriptor``),
+escucha el micrófono en bloques, corta cada frase al detectar silencio
+(``DetectorVoz``) y manda el pseudocódigo acumulado hasta esa frase al
+compilador residente en modo incremental, que solo recompila lo nuevo. Así
+no hay una grabación de duración fija ni se recarga el modelo por frase.
+"""
+import argparse
+import collections
+import functools
+import queue
+import time
+
+import numpy as np
+
+from compiler_client import CompiladorResidente, ErrorCompilacion
+
+FRECUENCIA = 16000
+
+
+@functools.lru_cache(maxsize=None)
+def obtener_transcriptor(model_name="openai/whisper-base"):
+    """Pipeline de reconocimiento de voz, creado la primera vez que se pide."""
+    import torch
+    from transformers import pipeline
+
+    print(f"Cargando modelo {model_name}...")
+    dispositivo = 0 if torch.cuda.is_available() else -1
+    return pipeline("automatic-speech-recognition", model=model_name, device=dispositivo)
+
+
+def transcribir(audio, model_name="openai/whisper-base", sample_rate=FRECUENCIA):
+    """Texto de `audio`: la ruta de un archivo o las muestras (float, mono)."""
+    if not isinstance(audio, str):
+        audio = {"raw": np.asarray(audio, dtype=np.float32).reshape(-1), "sampling_rate": sample_rate}
+    resultado = obtener_transcriptor(model_name)(audio)
+    if isinstance(resultado, dict):
+        return resultado.get("text", "")
+    return resultado if isinstance(resultado, str) else str(resultado)
+
+
+class DetectorVoz:
+    """Detección de voz por energía en tramas de 30 ms.
+
+    El umbral sigue al ruido de fondo medido fuera de las frases. Una frase
+    empieza en la primera trama con voz (más unas tramas previas, para no
+    cortar el comienzo) y termina tras ``silencio_ms`` sin voz; las que no
+    llegan a ``minimo_ms`` de voz se descartan como ruido.
+    """
+
+    def __init__(self, sample_rate=FRECUENCIA, trama_ms=30, silencio_ms=400, minimo_ms=200,
+                 previas_ms=150, factor=3.0, umbral_minimo=0.005):
+        self.trama = sample_rate * trama_ms // 1000
+        self.tramas_silencio = max(1, silencio_ms // trama_ms)
+        self.tramas_minimas = max(1, minimo_ms // trama_ms)
+        self.factor = factor
+        self.umbral_minimo = umbral_minimo
+        self.ruido = umbral_minimo
+        self.pendiente = np.zeros(0, dtype=np.float32)
+        self.previas = collections.deque(maxlen=max(0, previas_ms // trama_ms))
+        self._reiniciar()
+
+    def _reiniciar(self):
+        self.frase = []
+        self.hablando = False
+        self.con_voz = 0
+        self.en_silencio = 0
+
+    def _cerrar(self):
+        frase = np.concatenate(self.frase) if self.con_voz >= self.tramas_minimas else None
+        self._reiniciar()
+        return frase
+
+    def agregar(self, bloque):
+        """Procesa un bloque de muestras; devuelve las frases que terminan en él."""
+        datos = np.concatenate([self.pendiente, np.asarray(bloque, dtype=np.float32).reshape(-1)])
+        completas = len(datos) // self.trama * self.trama
+        self.pendiente = datos[completas:]
+
+        frases = []
+        for trama in datos[:completas].reshape(-1, self.trama):
+            energia = float(np.sqrt(np.mean(trama * trama)))
+            es_voz = energia > max(self.umbral_minimo, self.ruido * self.factor)
+            if not self.hablando:
+                if not es_voz:
+                    self.ruido = 0.95 * self.ruido + 0.05 * energia
+                    self.previas.append(trama)
+                    continue
+                self.hablando = True
+                self.frase.extend(self.previas)
+                self.previas.clear()
+            self.frase.append(trama)
+            if es_voz:
+                self.con_voz += 1
+                self.en_silencio = 0
+            else:
+                self.en_silencio += 1
+                if self.en_silencio >= self.tramas_silencio:
+                    frase = self._cerrar()
+                    if frase is not None:
+                        frases.append(frase)
+        return frases
+
+    def terminar(self):
+        """La frase en curso al dejar de escuchar (o None)."""
+        return self._cerrar() if self.hablando else None
+
+
+class ServicioTranscripcion:
+    """Modelo caliente + detector de voz + compilador residente incremental.
+
+    ``convertir`` pasa el texto de todas las frases (una por línea) a
+    pseudocódigo, p. ej. ``process_transcription`` de voice_to_code.py.
+    """
+
+    def __init__(self, convertir, model_name="openai/whisper-base",
+                 compiler_path="./build/proyecto_compiladores", sample_rate=FRECUENCIA):
+        self.convertir = convertir
+        self.model_name = model_name
+        self.sample_rate = sample_rate
+        self.detector = DetectorVoz(sample_rate)
+        self.frases = []
+        self.pseudocodigo = ""
+        self.codigo = ""
+        # La primera inferencia inicializa el modelo: que no la pague la primera frase
+        transcribir(np.zeros(sample_rate // 2, dtype=np.float32), model_name, sample_rate)
+        self.compilador = CompiladorResidente(compiler_path, incremental=True)
+
+    def procesar_frase(self, audio):
+        """Transcribe una frase y recompila el programa con ella.
+
+        Devuelve (texto, segundos desde el fin de la frase, error o None), o
+        None si la frase no tenía texto.
+        """
+        inicio = time.perf_counter()
+        texto = transcribir(audio, self.model_name, self.sample_rate).strip()
+        if not texto:
+            return None
+        self.frases.append(texto)
+        self.pseudocodigo = self.convertir("\n".join(self.frases))
+        error = None
+        try:
+            self.codigo = self.compilador.compilar(self.pseudocodigo)
+        except ErrorCompilacion as e:
+            error = str(e)
+        return texto, time.perf_counter() - inicio, error
+
+    def escuchar(self, al_procesar, duracion_maxima=None):
+        """Escucha hasta Ctrl+C (o `duracion_maxima` segundos) y llama a
+        ``al_procesar(resultado)`` tras cada frase."""
+        import sounddevice as sd
+
+        bloques = queue.Queue()
+
+        def recibir(indata, frames, time_info, status):
+            bloques.put(indata[:, 0].copy())
+
+        limite = time.monotonic() + duracion_maxima if duracion_maxima else None
+        with sd.InputStream(samplerate=self.sample_rate, channels=1, dtype="float32",
+                            blocksize=self.detector.trama, callback=recibir):
+            print("Escuchando... (Ctrl+C para terminar)")
+            try:
+                while limite is None or time.monotonic() < limite:
+                    try:
+                        bloque = bloques.get(timeout=0.1)
+                    except queue.Empty:
+                        continue
+                    for frase in self.detector.agregar(bloque):
+                        resultado = self.procesar_frase(frase)
+                        if resultado:
+                            al_procesar(resultado)
+            except KeyboardInterrupt:
+                pass
+        frase = self.detector.terminar()
+        if frase is not None:
+            resultado = self.procesar_frase(frase)
+            if resultado:
+                al_procesar(resultado)
+
+    def cerrar(self):
+        self.compilador.cerrar()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.cerrar()
+
+
+def dictar(convertir, model_name, compiler_path, output, duracion_maxima=None):
+    """Modo dictado de los scripts de voz: muestra el C++ tras cada frase y al
+    terminar guarda el pseudocódigo y el C++ finales."""
+    with ServicioTranscripcion(convertir, model_name, compiler_path) as servicio:
+        def mostrar(resultado):
+            texto, segundos, error = resultado
+            print(f"\n> {texto}   ({segundos * 1000:.0f} ms)")
+            if error:
+                print(f"Error en la compilación: {error}")
+            else:
+                print(servicio.codigo)
+
+        servicio.escuchar(mostrar, duracion_maxima)
+        if not servicio.frases:
+            print("No se detectó ninguna frase.")
+            return None
+        with open(output, "w") as f:
+            f.write(servicio.pseudocodigo)
+        print(f"Pseudocódigo guardado en: {output}")
+        if servicio.codigo:
+            cpp_file = output.rsplit(".", 1)[0] + ".cpp"
+            with open(cpp_file, "w") as f:
+                f.write(servicio.codigo)
+            print(f"Código C++ generado en: {cpp_file}")
+        return output
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Dictado de pseudocódigo con el modelo siempre cargado")
+    parser.add_argument("--model", type=str, default="openai/whisper-base", help="Modelo de transformers a utilizar")
+    parser.add_argument("--compiler", type=str, default="./build/proyecto_compiladores", help="Ejecutable del compilador")
+    parser.add_argument("--output", type=str, default="input.pseudo", help="Nombre del archivo de pseudocódigo")
+    parser.add_argument("--duration", type=int, default=None, help="Segundos máximos de escucha (sin límite por defecto)")
+    parser.add_argument("--estructurado", action="store_true",
+                        help="Convertir como structured_voice_to_code.py (instrucciones habladas)")
+    args = parser.parse_args()
+
+    if args.estructurado:
+        from structured_voice_to_code import convert_to_pseudocode as convertir
+    else:
+        from voice_to_code import process_transcription as convertir
+    dictar(convertir, args.model, args.compiler, args.output, args.duration)
+
+
+if __name__ == "__main__":
+    main()
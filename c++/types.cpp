@@ -0,0 +1,339 @@
+#include "types.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+
+using namespace std;
+
+namespace {
+
+struct NombreTipo {
+    string_view nombre;
+    TipoDato tipo;
+};
+
+const NombreTipo NOMBRES_TIPO[] = {
+    {"entero", TipoDato::ENTERO},
+    {"real", TipoDato::REAL},
+    {"numero", TipoDato::REAL},
+    {"numerico", TipoDato::REAL},
+    {"cadena", TipoDato::CADENA},
+    {"texto", TipoDato::CADENA},
+    {"caracter", TipoDato::CADENA},
+    {"logico", TipoDato::LOGICO},
+    {"booleano", TipoDato::LOGICO}
+};
+
+bool igualSinMayusculas(string_view a, string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+TipoDato unir(TipoDato a, TipoDato b) {
+    return max(a, b);
+}
+
+// Variable cuyo tipo se anota en el nodo (SIN_SIMBOLO si no es de los que se anotan).
+// DECLARACION conserva el tipo escrito en el programa. Los arreglos tienen el
+// tipo de sus elementos.
+SimboloId variableDe(const ArbolAST& arbol, NodoId id) {
+    const NodoAST& nodo = arbol[id];
+    switch (nodo.tipo) {
+    case TipoNodo::ASIGNACION:
+    case TipoNodo::PARA:
+    case TipoNodo::DIMENSION:
+    case TipoNodo::PARAMETRO:
+        return nodo.simbolo;
+    case TipoNodo::LEER:
+        return nodo.numHijos > 0 ? arbol[arbol.hijosDe(id)[0]].simbolo : SIN_SIMBOLO;
+    default:
+        return SIN_SIMBOLO;
+    }
+}
+
+} // namespace
+
+TipoDato tipoLiteral(string_view numero) {
+    if (numero.find('.') != string_view::npos) return TipoDato::REAL;
+    long long valor;
+    auto [ptr, ec] = from_chars(numero.data(), numero.data() + numero.size(), valor);
+    if (ec != errc() || valor > INT_MAX || valor < INT_MIN) return TipoDato::ENTERO_LARGO;
+    return TipoDato::ENTERO;
+}
+
+TipoDato tipoDeNombre(string_view nombre) {
+    for (const NombreTipo& entrada : NOMBRES_TIPO) {
+        if (igualSinMayusculas(nombre, entrada.nombre)) return entrada.tipo;
+    }
+    return TipoDato::DESCONOCIDO;
+}
+
+string_view tipoCpp(TipoDato tipo) {
+    switch (tipo) {
+    case TipoDato::LOGICO: return "bool";
+    case TipoDato::ENTERO_LARGO: return "long long";
+    case TipoDato::REAL: return "double";
+    case TipoDato::CADENA: return "string";
+    default: return "int";
+    }
+}
+
+void InferenciaTipos::agregar(const ArbolAST& arbol, NodoId raiz) {
+    if (raiz == NODO_NULO) return;
+    pendientes.assign(1, raiz);
+    while (!pendientes.empty()) {
+        NodoId id = pendientes.back();
+        pendientes.pop_back();
+        const NodoAST& nodo = arbol[id];
+        RangoHijos hijos = arbol.hijosDe(id);
+        for (NodoId hijo : hijos) pendientes.push_back(hijo);
+        // Solo cuentan los nodos con nombre de variable
+        if (nodo.simbolo == SIN_SIMBOLO) continue;
+
+        switch (nodo.tipo) {
+        case TipoNodo::DECLARACION: {
+            // Varias declaraciones de la misma variable se unen: el resultado no
+            // depende del orden en que se recorren (la compilación incremental
+            // agrega las sentencias una a una)
+            TipoDato& declarado = variable(nodo.simbolo).declarado;
+            declarado = unir(declarado, nodo.tipoDato);
+            break;
+        }
+        case TipoNodo::DIMENSION:
+            variable(nodo.simbolo).arreglo = true;
+            break;
+        case TipoNodo::ASIGNACION:
+            if (!hijos.empty()) asignaciones.push_back({nodo.simbolo, &arbol, hijos[0]});
+            if (hijos.size() > 1) variable(nodo.simbolo).indexada = true;
+            break;
+        case TipoNodo::ELEMENTO:
+            variable(nodo.simbolo).indexada = true;
+            break;
+        case TipoNodo::PARA:
+            // El contador es al menos entero aunque los límites sean booleanos
+            variable(nodo.simbolo).inferido = unir(variable(nodo.simbolo).inferido, TipoDato::ENTERO);
+            for (size_t i = 0; i < hijos.size() && i < 2; i++) {
+                if (arbol[hijos[i]].tipo != TipoNodo::BLOQUE) asignaciones.push_back({nodo.simbolo, &arbol, hijos[i]});
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void InferenciaTipos::resolver() {
+    // Los tipos solo suben en un orden finito: termina en pocas vueltas
+    bool cambio = true;
+    while (cambio) {
+        cambio = false;
+        for (const Asignacion& asignacion : asignaciones) {
+            Variable& variable = this->variable(asignacion.variable);
+            if (variable.declarado != TipoDato::DESCONOCIDO) continue;
+            TipoDato tipo = unir(variable.inferido, tipoExpresion(*asignacion.arbol, asignacion.expresion));
+            if (tipo != variable.inferido) {
+                variable.inferido = tipo;
+                cambio = true;
+            }
+        }
+    }
+}
+
+TipoDato InferenciaTipos::tipoExpresion(const ArbolAST& arbol, NodoId id) const {
+    const NodoAST& nodo = arbol[id];
+    switch (nodo.tipo) {
+    case TipoNodo::NUMERO:
+        return tipoLiteral(nodo.valor);
+    case TipoNodo::CADENA:
+        return TipoDato::CADENA;
+    case TipoNodo::EXPRESION: // Verdadero o Falso
+        return TipoDato::LOGICO;
+    case TipoNodo::IDENTIFICADOR:
+    case TipoNodo::ELEMENTO:
+        return tipoDe(nodo.simbolo);
+    case TipoNodo::LLAMADA:
+        return retornos && nodo.simbolo < retornos->size() ? (*retornos)[nodo.simbolo] : TipoDato::DESCONOCIDO;
+    case TipoNodo::OPERACION_BINARIA: {
+        if (nodo.numHijos < 2) return TipoDato::DESCONOCIDO;
+        if (precedencia(nodo.operador) <= precedencia(Operador::MENOR)) return TipoDato::LOGICO;
+        RangoHijos hijos = arbol.hijosDe(id);
+        // Aritmética de C++: bool + bool ya es int
+        return unir(TipoDato::ENTERO, unir(tipoExpresion(arbol, hijos[0]), tipoExpresion(arbol, hijos[1])));
+    }
+    default:
+        return TipoDato::DESCONOCIDO;
+    }
+}
+
+bool InferenciaTipos::cambiarTipo(ArbolAST& arbol, NodoId id, TipoDato tipo) {
+    if (arbol.nodos[id].tipoDato == tipo) return false;
+    arbol.nodos[id].tipoDato = tipo;
+    return true;
+}
+
+InferenciaTipos::Variable& InferenciaTipos::variable(SimboloId simbolo) {
+    if (simbolo >= variables.size()) variables.resize(simbolo + 1);
+    return variables[simbolo];
+}
+
+TipoDato InferenciaTipos::tipoDe(SimboloId simbolo) const {
+    if (simbolo >= variables.size()) return TipoDato::DESCONOCIDO;
+    const Variable& variable = variables[simbolo];
+    return variable.declarado != TipoDato::DESCONOCIDO ? variable.declarado : variable.inferido;
+}
+
+bool InferenciaTipos::esArreglo(SimboloId simbolo) const {
+    return simbolo < variables.size() && (variables[simbolo].arreglo || variables[simbolo].indexada);
+}
+
+bool InferenciaTipos::unirTipo(SimboloId simbolo, TipoDato tipo) {
+    TipoDato& inferido = variable(simbolo).inferido;
+    if (unir(inferido, tipo) == inferido) return false;
+    inferido = unir(inferido, tipo);
+    return true;
+}
+
+bool InferenciaTipos::marcarArreglo(SimboloId simbolo) {
+    if (variable(simbolo).arreglo) return false;
+    variable(simbolo).arreglo = true;
+    return true;
+}
+
+bool InferenciaTipos::anotar(ArbolAST& arbol, NodoId raiz) const {
+    if (raiz == NODO_NULO) return false;
+    bool cambio = false;
+    pendientes.assign(1, raiz);
+    while (!pendientes.empty()) {
+        NodoId id = pendientes.back();
+        pendientes.pop_back();
+        SimboloId variable = variableDe(arbol, id);
+        if (variable != SIN_SIMBOLO) {
+            cambio |= cambiarTipo(arbol, id, tipoDe(variable));
+        }
+        const NodoAST& nodo = arbol[id];
+        if (nodo.tipo == TipoNodo::PARA && nodo.numHijos > 2) {
+            // El generador solo saca el Hasta del bucle si cabe en el contador
+            NodoId hasta = arbol.hijosDe(id)[1];
+            cambio |= cambiarTipo(arbol, hasta, tipoExpresion(arbol, hasta));
+        } else if (nodo.tipo == TipoNodo::DECLARACION || nodo.tipo == TipoNodo::PARAMETRO) {
+            // Un parámetro es un arreglo también si solo se usa con índice
+            bool arreglo = nodo.simbolo < variables.size() && variables[nodo.simbolo].arreglo;
+            if (nodo.tipo == TipoNodo::PARAMETRO) arreglo = esArreglo(nodo.simbolo);
+            if (nodo.arreglo != arreglo) {
+                arbol.nodos[id].arreglo = arreglo;
+                cambio = true;
+            }
+        } else if (nodo.tipo == TipoNodo::LLAMADA) {
+            cambio |= cambiarTipo(arbol, id, tipoExpresion(arbol, id));
+        } else if (nodo.tipo == TipoNodo::FUNCION && nodo.numHijos > 2) {
+            cambio |= cambiarTipo(arbol, id, tipoDe(arbol[arbol.hijosDe(id)[2]].simbolo));
+        }
+        for (NodoId hijo : arbol.hijosDe(id)) pendientes.push_back(hijo);
+    }
+    return cambio;
+}
+
+void InferenciaTipos::limpiar() {
+    variables.clear();
+    asignaciones.clear();
+}
+
+void inferirTipos(ArbolAST& arbol) {
+    MemoriaTipos memoria;
+    inferirTipos(arbol, memoria);
+}
+
+void inferirTipos(ArbolAST& arbol, MemoriaTipos& memoria) {
+    if (arbol.raiz == NODO_NULO) return;
+    vector<NodoId>& unidades = memoria.unidades;
+    unidades.assign(1, arbol.raiz);
+    if (arbol[arbol.raiz].tipo == TipoNodo::PROGRAMA) {
+        RangoHijos hijos = arbol.hijosDe(arbol.raiz);
+        unidades.assign(hijos.begin(), hijos.end());
+    }
+
+    // Ámbito de cada función, por id de su nombre (la primera definición)
+    const size_t NINGUNA = SIZE_MAX;
+    vector<size_t>& ambitoDe = memoria.ambitoDe;
+    vector<TipoDato>& retornos = memoria.retornos;
+    ambitoDe.clear();
+    retornos.clear();
+    for (size_t u = 0; u < unidades.size(); u++) {
+        const NodoAST& nodo = arbol[unidades[u]];
+        if (nodo.tipo != TipoNodo::FUNCION) continue;
+        if (nodo.simbolo >= ambitoDe.size()) {
+            ambitoDe.resize(nodo.simbolo + 1, NINGUNA);
+            retornos.resize(nodo.simbolo + 1, TipoDato::DESCONOCIDO);
+        }
+        if (ambitoDe[nodo.simbolo] == NINGUNA) ambitoDe[nodo.simbolo] = u;
+    }
+
+    // Los ámbitos de sobra de una compilación anterior se conservan sin usar
+    vector<InferenciaTipos>& ambitos = memoria.ambitos;
+    vector<vector<NodoId>>& llamadas = memoria.llamadas;
+    if (ambitos.size() < unidades.size()) {
+        ambitos.resize(unidades.size());
+        llamadas.resize(unidades.size());
+    }
+    vector<NodoId>& pendientes = memoria.pendientes;
+    for (size_t u = 0; u < unidades.size(); u++) {
+        ambitos[u].limpiar();
+        ambitos[u].usarRetornos(&retornos);
+        ambitos[u].agregar(arbol, unidades[u]);
+        llamadas[u].clear();
+        pendientes.assign(1, unidades[u]);
+        while (!pendientes.empty()) {
+            NodoId id = pendientes.back();
+            pendientes.pop_back();
+            const NodoAST& nodo = arbol[id];
+            if (nodo.tipo == TipoNodo::LLAMADA && nodo.simbolo < ambitoDe.size() && ambitoDe[nodo.simbolo] != NINGUNA) {
+                llamadas[u].push_back(id);
+            }
+            for (NodoId hijo : arbol.hijosDe(id)) pendientes.push_back(hijo);
+        }
+    }
+
+    // Los tipos solo suben: termina en pocas vueltas
+    bool cambio = true;
+    while (cambio) {
+        cambio = false;
+        for (size_t u = 0; u < unidades.size(); u++) ambitos[u].resolver();
+
+        for (size_t u = 0; u < unidades.size(); u++) {
+            const NodoAST& nodo = arbol[unidades[u]];
+            if (nodo.tipo != TipoNodo::FUNCION || ambitoDe[nodo.simbolo] != u || nodo.numHijos < 3) continue;
+            TipoDato retorno = ambitos[u].tipoDe(arbol[arbol.hijosDe(unidades[u])[2]].simbolo);
+            if (retorno != retornos[nodo.simbolo]) {
+                retornos[nodo.simbolo] = retorno;
+                cambio = true;
+            }
+        }
+
+        for (size_t u = 0; u < unidades.size(); u++) {
+            for (NodoId llamada : llamadas[u]) {
+                size_t f = ambitoDe[arbol[llamada].simbolo];
+                RangoHijos parametros = arbol.hijosDe(arbol.hijosDe(unidades[f])[0]);
+                RangoHijos argumentos = arbol.hijosDe(llamada);
+                for (size_t k = 0; k < parametros.size() && k < argumentos.size(); k++) {
+                    const NodoAST& parametro = arbol[parametros[k]];
+                    const NodoAST& argumento = arbol[argumentos[k]];
+                    cambio |= ambitos[f].unirTipo(parametro.simbolo, ambitos[u].tipoExpresion(arbol, argumentos[k]));
+                    if (argumento.tipo != TipoNodo::IDENTIFICADOR) continue;
+                    if (ambitos[u].esArreglo(argumento.simbolo)) cambio |= ambitos[f].marcarArreglo(parametro.simbolo);
+                    // Por referencia (los arreglos siempre) el argumento tiene que ser del mismo tipo
+                    if (parametro.numHijos > 0 || ambitos[f].esArreglo(parametro.simbolo)) {
+                        cambio |= ambitos[u].unirTipo(argumento.simbolo, ambitos[f].tipoDe(parametro.simbolo));
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t u = 0; u < unidades.size(); u++) {
+        ambitos[u].anotar(arbol, unidades[u]);
+    }
+}
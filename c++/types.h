@@ -0,0 +1,92 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <string_view>
+#include <vector>
+#include "ast.h"
+
+using namespace std;
+
+// Nombre de tipo del pseudocódigo ("entero", "Real", "cadena"...);
+// DESCONOCIDO si no lo es.
+TipoDato tipoDeNombre(string_view nombre);
+// Tipo de C++ con el que se declara una variable (int si no se sabe nada)
+string_view tipoCpp(TipoDato tipo);
+// Tipo de un literal numérico como en C++: double si tiene punto, int si cabe
+// y si no long long
+TipoDato tipoLiteral(string_view numero);
+
+// Inferencia de tipos por variable, sin distinguir posiciones del programa:
+// el tipo de una variable es el declarado (var / Definir) o, si no lo tiene,
+// la unión de los tipos de todo lo que se le asigna (incluidos los límites de
+// los Para que la usan). Se itera hasta un punto fijo porque una asignación
+// puede depender de variables asignadas más adelante. Cada instancia es un
+// ámbito: el algoritmo o un SubProceso (ver inferirTipos).
+class InferenciaTipos {
+public:
+    // Registra las declaraciones y asignaciones del subárbol de `raiz`. El
+    // árbol debe seguir vivo (y sin cambios) hasta terminar de anotar, y todos
+    // los árboles agregados deben compartir tabla de símbolos.
+    void agregar(const ArbolAST& arbol, NodoId raiz);
+    void resolver();
+    // Escribe en tipoDato de los nodos ASIGNACION, LEER, PARA, DIMENSION y
+    // PARAMETRO el tipo de su variable, en el Hasta de cada Para el de la
+    // expresión y en FUNCION y LLAMADA el que devuelve la función; marca las
+    // DECLARACION y los PARAMETRO de arreglos. Devuelve true si cambió alguno.
+    bool anotar(ArbolAST& arbol, NodoId raiz) const;
+
+    TipoDato tipoDe(SimboloId variable) const;
+    TipoDato tipoExpresion(const ArbolAST& arbol, NodoId id) const;
+    // Tiene Dimension o se usa con índice
+    bool esArreglo(SimboloId variable) const;
+    // Tipo devuelto por cada función, por id de su nombre (para las LLAMADA;
+    // sin esto son DESCONOCIDO). Debe seguir vivo mientras se use la inferencia.
+    void usarRetornos(const vector<TipoDato>* retornos) { this->retornos = retornos; }
+    // La variable también recibe un valor de tipo `tipo` (un argumento que le
+    // pasa un llamador, ...). Devuelven true si cambió algo.
+    bool unirTipo(SimboloId variable, TipoDato tipo);
+    bool marcarArreglo(SimboloId variable);
+    void limpiar();
+
+private:
+    struct Variable {
+        TipoDato declarado = TipoDato::DESCONOCIDO;
+        TipoDato inferido = TipoDato::DESCONOCIDO;
+        bool arreglo = false;  // tiene Dimension (o un llamador le pasa un arreglo)
+        bool indexada = false; // se usa como a[i]
+    };
+    struct Asignacion {
+        SimboloId variable;
+        const ArbolAST* arbol;
+        NodoId expresion;
+    };
+
+    Variable& variable(SimboloId simbolo);
+    static bool cambiarTipo(ArbolAST& arbol, NodoId id, TipoDato tipo);
+
+    vector<Variable> variables; // por id de símbolo
+    vector<Asignacion> asignaciones;
+    const vector<TipoDato>* retornos = nullptr;
+    mutable vector<NodoId> pendientes; // recorrido de agregar y anotar, sin reservar cada vez
+};
+
+// Lo que inferirTipos necesita además del árbol. Un Compilador conserva la
+// suya entre compilaciones: con programas de tamaño parecido ya no reserva.
+struct MemoriaTipos {
+    vector<NodoId> unidades;
+    vector<size_t> ambitoDe;
+    vector<TipoDato> retornos;
+    vector<InferenciaTipos> ambitos;
+    vector<vector<NodoId>> llamadas;
+    vector<NodoId> pendientes;
+};
+
+// Pase completo sobre un árbol (lo que usa Compilador). El algoritmo y cada
+// SubProceso son ámbitos separados; entre ellos se itera hasta un punto fijo:
+// un parámetro recibe el tipo de los argumentos de todas las llamadas (y un
+// argumento por referencia, el del parámetro), y una llamada tiene el tipo de
+// la variable de retorno.
+void inferirTipos(ArbolAST& arbol);
+void inferirTipos(ArbolAST& arbol, MemoriaTipos& memoria);
+
+#endif
@@ -1,20 +1,94 @@
 #include "utils.h"
 #include <fstream>
-#include <sstream>
 #include <iostream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define USAR_MMAP 1
+#endif
+
+#ifdef USAR_MMAP
+namespace {
+
+// Lee lo que quede en `fd` (una tubería o un archivo especial) hasta el final
+bool leerDescriptor(int fd, string& contenido) {
+    char bloque[64 * 1024];
+    for (;;) {
+        ssize_t n = read(fd, bloque, sizeof(bloque));
+        if (n == 0) return true;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        contenido.append(bloque, (size_t)n);
+    }
+}
+
+} // namespace
+#endif
 
 string leerArchivo(const string& filename) {
-    ifstream file(filename);
+    ifstream file(filename, ios::binary);
     if (!file.is_open()) {
         return "";
     }
     
-    stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    // Leer directamente al tamaño final, sin pasar por un stringstream. Una
+    // tubería (/dev/stdin, <(...)) no tiene tamaño: se lee hasta el final.
+    // Con ios::ate el ifstream se cerraría al no poder ir al final.
+    file.seekg(0, ios::end);
+    streamoff tam = file.tellg();
+    if (tam < 0) {
+        file.clear();
+        return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    string contenido(static_cast<size_t>(tam), '\0');
+    file.seekg(0);
+    file.read(&contenido[0], contenido.size());
+    contenido.resize(static_cast<size_t>(file.gcount()));
+    return contenido;
 }
 
-void guardarArchivo(const string& filename, const string& contenido) {
+ArchivoMapeado::ArchivoMapeado(const string& filename) : datos(nullptr), tam(0), mapeado(false) {
+#ifdef USAR_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat info;
+    bool regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+    if (regular && info.st_size > 0) {
+        void* p = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, info.st_size, MADV_SEQUENTIAL);
+            datos = static_cast<const char*>(p);
+            tam = info.st_size;
+            mapeado = true;
+        }
+    }
+    // Una tubería con nombre no se puede volver a abrir para leerla: se lee
+    // de este mismo descriptor
+    if (!mapeado && !leerDescriptor(fd, respaldo)) respaldo.clear();
+    close(fd);
+#else
+    respaldo = leerArchivo(filename);
+#endif
+    if (!mapeado) {
+        datos = respaldo.data();
+        tam = respaldo.size();
+    }
+}
+
+ArchivoMapeado::~ArchivoMapeado() {
+#ifdef USAR_MMAP
+    if (mapeado) munmap(const_cast<char*>(datos), tam);
+#endif
+}
+
+FILE* abrirArchivoSalida(const string& filename, string& rutaSalida) {
     // Extraer el nombre del archivo sin la ruta
     string basename = filename;
     size_t lastSlash = filename.find_last_of("/\\");
@@ -25,17 +99,26 @@ void guardarArchivo(const string& filename, const string& contenido) {
     // Construir la ruta en cmake-build-debug
     string outputPath = basename;
     
-    ofstream file(outputPath);
-    if (file.is_open()) {
-        file << contenido;
-        std::cout << "Archivo guardado en: " << outputPath << endl;
-    } else {
-        std::cerr << "Error: No se pudo guardar en " << outputPath << ". Intentando en ubicación original." << endl;
-        // Fallback a la ubicación original
-        ofstream originalFile(filename);
-        if (originalFile.is_open()) {
-            originalFile << contenido;
-        }
+    FILE* file = fopen(outputPath.c_str(), "wb");
+    if (file) {
+        rutaSalida = outputPath;
+        return file;
+    }
+    
+    std::cerr << "Error: No se pudo guardar en " << outputPath << ". Intentando en ubicación original." << endl;
+    // Fallback a la ubicación original
+    file = fopen(filename.c_str(), "wb");
+    if (file) rutaSalida = filename;
+    return file;
+}
+
+void guardarArchivo(const string& filename, const string& contenido) {
+    string ruta;
+    FILE* file = abrirArchivoSalida(filename, ruta);
+    if (file) {
+        fwrite(contenido.data(), 1, contenido.size(), file);
+        fclose(file);
+        std::cout << "Archivo guardado en: " << ruta << endl;
     }
 }
 
@@ -1,13 +1,37 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstdio>
 #include <string>
+#include <string_view>
 #include <fstream>
 
 using namespace std;
 
 string leerArchivo(const string& filename);
 void guardarArchivo(const string& filename, const string& contenido);
+// Abre el archivo de salida con el mismo criterio que guardarArchivo (nombre
+// base en el directorio actual y, si falla, la ruta original). nullptr si no.
+FILE* abrirArchivoSalida(const string& filename, string& rutaSalida);
 string cambiarExtension(const string& filename, const string& nuevaExtension);
 
+// Archivo de entrada mapeado en memoria (solo lectura). Si el mapeo no está
+// disponible se hace una lectura normal a un buffer propio.
+class ArchivoMapeado {
+public:
+    explicit ArchivoMapeado(const string& filename);
+    ~ArchivoMapeado();
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    string_view contenido() const { return string_view(datos, tam); }
+
+private:
+    const char* datos;
+    size_t tam;
+    bool mapeado;
+    string respaldo;
+};
+
 #endif
\ No newline at end of file
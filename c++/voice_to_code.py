@@ -2,7 +2,8 @@
 import os
 import argparse
 import torch
-from transformers import pipeline
+from transcription_service import obtener_transcriptor, dictar
+from ejecucion import ejecutar_pseudocodigo
 import sounddevice as sd
 import numpy as np
 import scipy.io.wavfile as wav
@@ -24,8 +25,8 @@ def save_audio(audio, sample_rate, filename="temp_audio.wav"):
 def transcribe_audio(audio_file, model_name="openai/whisper-base"):
     """Transcribe el audio a texto usando un modelo transformer."""
     try:
-        print(f"Cargando modelo {model_name}...")
-        transcriber = pipeline("automatic-speech-recognition", model=model_name)
+        # El modelo se carga una vez por proceso y se reutiliza
+        transcriber = obtener_transcriptor(model_name)
         print("Transcribiendo audio...")
         result = transcriber(audio_file)
         
@@ -127,9 +128,31 @@ def save_pseudocode(text, filename="input.pseudo"):
     return filename
 
 def compile_pseudocode(pseudo_file, compiler_path="./build/proyecto_compiladores"):
-    """Compila el pseudocódigo usando el compilador C++."""
+    """Compila el pseudocódigo usando el compilador C++.
+
+    Si está construida libpseudocompilador.so compila en este mismo proceso;
+    si no, lanza el ejecutable.
+    """
+    import compilador_nativo
+    if compilador_nativo.disponible(compiler_path):
+        cpp_file = os.path.splitext(os.path.basename(pseudo_file))[0] + ".cpp"
+        try:
+            with open(pseudo_file, "rb") as f:
+                content = f.read()
+            with compilador_nativo.CompiladorNativo(compiler_path=compiler_path) as compilador:
+                code = compilador.compilar_buffer(content)
+                with open(cpp_file, "wb") as f:
+                    f.write(code)
+            print("Compilación exitosa:")
+            print(f"Código C++ generado en: {cpp_file}")
+        except compilador_nativo.ErrorCompilacion as e:
+            print("Error en la compilación:")
+            print(e)
+        except OSError as e:
+            print(f"Error al ejecutar el compilador: {e}")
+        return
     try:
-        result = subprocess.run([compiler_path, pseudo_file], 
+        result = subprocess.run([compiler_path, "--ignorar-mayusculas", pseudo_file], 
                                capture_output=True, text=True)
         if result.returncode == 0:
             print("Compilación exitosa:")
@@ -140,6 +163,28 @@ def compile_pseudocode(pseudo_file, compiler_path="./build/proyecto_compiladores
     except Exception as e:
         print(f"Error al ejecutar el compilador: {e}")
 
+def edit_and_compile(pseudo_file, compiler_path="./build/proyecto_compiladores"):
+    """Ciclo de edición: el compilador queda residente y solo recompila lo editado."""
+    from compiler_client import CompiladorResidente, ErrorCompilacion
+
+    editor = os.environ.get("EDITOR", "nano")
+    cpp_file = os.path.splitext(os.path.basename(pseudo_file))[0] + ".cpp"
+    with CompiladorResidente(compiler_path, incremental=True) as compilador:
+        while True:
+            subprocess.run([editor, pseudo_file])
+            with open(pseudo_file, "r") as f:
+                content = f.read()
+            try:
+                code = compilador.compilar(content)
+                with open(cpp_file, "w") as f:
+                    f.write(code)
+                print(f"Compilación exitosa. Código C++ generado en: {cpp_file}")
+            except ErrorCompilacion as e:
+                print("Error en la compilación:")
+                print(e)
+            if input("¿Editar de nuevo? [s/N] ").strip().lower() != "s":
+                break
+
 def check_dependencies():
     """Verifica que las dependencias externas estén instaladas."""
     try:
@@ -175,9 +220,17 @@ def main():
     parser.add_argument("--compile", action="store_true", help="Compilar automáticamente el pseudocódigo")
     parser.add_argument("--example", action="store_true", help="Usar un ejemplo predefinido en lugar de grabar audio")
     parser.add_argument("--edit", action="store_true", help="Abrir el pseudocódigo en un editor antes de compilar")
+    parser.add_argument("--run", action="store_true",
+                        help="Ejecutar el programa al momento con el intérprete (g++ solo si tarda)")
+    parser.add_argument("--stream", action="store_true",
+                        help="Dictado continuo: compila tras cada frase con el modelo y el compilador residentes")
     
     args = parser.parse_args()
     
+    if args.stream:
+        dictar(process_transcription, args.model, "./build/proyecto_compiladores", args.output)
+        return
+    
     if args.example:
         # Usar ejemplo predefinido
         print("Usando ejemplo predefinido...")
@@ -206,6 +259,11 @@ def main():
         # Eliminar archivo de audio temporal
         os.remove(audio_file)
     
+    # Editar y compilar en ciclo con el compilador residente
+    if args.edit and args.compile:
+        edit_and_compile(pseudo_file)
+        return
+    
     # Abrir en editor si se solicita
     if args.edit:
         editor = os.environ.get("EDITOR", "nano")
@@ -223,6 +281,10 @@ def main():
             print("No se compiló debido a posibles problemas en el pseudocódigo.")
             print("Puedes editar el archivo manualmente y luego compilarlo con:")
             print(f"./build/proyecto_compiladores {pseudo_file}")
+
+    if args.run and is_valid:
+        print("Ejecutando el programa...")
+        ejecutar_pseudocodigo(pseudo_file)
     
     # Ya se eliminó el archivo de audio temporal en la sección correspondiente
 